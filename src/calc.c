@@ -33,6 +33,35 @@ unsigned long ConvertDegByOrComposeArg(char *arg) {
     }
 }
 
+/**
+ * Konwertuje napis @p arg postaci "a b" na dwa nieujemne argumenty
+ * instrukcji.
+ * @param[in] arg : argumenty jako napis
+ * @param[out] first : pierwszy argument
+ * @param[out] second : drugi argument
+ * @return czy napis jest poprawny
+ */
+bool ConvertTwoArgs(char *arg, unsigned long *first, unsigned long *second) {
+    char *remainder;
+    if (!isdigit(arg[0])) {
+        return false;
+    }
+
+    *first = strtoul(arg, &remainder, DEC);
+    if (remainder[0] != ' ' || !isdigit(remainder[1]) || errno == ERANGE) {
+        errno = 0;
+        return false;
+    }
+
+    *second = strtoul(&remainder[1], &remainder, DEC);
+    if (remainder[0] != '\0' || errno == ERANGE) {
+        errno = 0;
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * Konwertuje napis @p arg na argument do instrukcji @p At.
  * @param[in] arg : argument jako napis
@@ -51,6 +80,39 @@ long ConvertAtArg(char *arg) {
     }
 }
 
+/**
+ * Konwertuje napis @p arg postaci "idx x" na indeks zmiennej i wartość
+ * całkowitą, zapisaną tak jak argument instrukcji @p At.
+ * @param[in] arg : argumenty jako napis
+ * @param[out] idx : indeks zmiennej
+ * @param[out] value : wartość
+ * @return czy napis jest poprawny
+ */
+bool ConvertVarArgs(char *arg, unsigned long *idx, long *value) {
+    char *remainder;
+    if (!isdigit(arg[0])) {
+        return false;
+    }
+
+    *idx = strtoul(arg, &remainder, DEC);
+    if (remainder[0] != ' ' || errno == ERANGE) {
+        errno = 0;
+        return false;
+    }
+
+    arg = &remainder[1];
+    *value = strtol(arg, &remainder, DEC);
+    if (!isdigit(arg[0]) && !(arg[0] == '-' && isdigit(arg[1]))) {
+        return false;
+    }
+    else if (remainder[0] != '\0' || errno == ERANGE) {
+        errno = 0;
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * Sprawdza czy napis reprezentuje wielomian, który jest współczynnikiem.
  * @param[in] str : wielomian jako napis
@@ -158,12 +220,25 @@ size_t NumberOfMonos(const char *str) {
 
 /**
  * Konwertuje część napisu jako współczynnik jednomianu
- * i nadpisuje do *str resztę.
+ * i nadpisuje do *str resztę. W trybie dokładnym współczynnik może mieć
+ * dowolnie wiele cyfr.
  * @param[in] str : napis
  * @return współczynnik jednomianu
  */
 Poly ConvertCoeff(char **str) {
     char *remainder;
+
+    if (PolyGetExact()) {
+        Poly result = PolyCoeffFromString((*str) + 1, &remainder);
+        if (remainder[0] != ',') {
+            PolyDestroy(&result);
+            return PolyZero();
+        }
+
+        *str = ++remainder;
+        return result;
+    }
+
     long result = strtol((*str) + 1, &remainder, DEC);
 
     if (remainder[0] != ',' || errno == ERANGE) {
@@ -232,16 +307,14 @@ Mono ConvertMono(char **str) {
  */
 Poly ConvertPoly(char **str) {
     size_t monos_size = NumberOfMonos(*str);
-    Mono *monos = malloc(monos_size * sizeof(Mono));
-    CHECK_PTR(monos);
+    PolyBuilder b = PolyBuilderInit(monos_size);
     for (size_t i = 0; i < monos_size; i++) {
-        monos[i] = ConvertMono(str);
+        Mono m = ConvertMono(str);
+        PolyBuilderAdd(&b, &m);
     }
     (*str)++;
 
-    Poly p = PolyAddMonos(monos_size, monos);
-    free(monos);
-    return p;
+    return PolyBuilderFinish(&b);
 }
 
 /**
@@ -277,12 +350,21 @@ void ParseInstruction(Stack *s, char *buffer, ssize_t line_length, int line_numb
     else if (line_length == 4 && strncmp(buffer, "SUB", 3) == 0) {
         ExecSub(s, line_number);
     }
+    else if (line_length == 4 && strncmp(buffer, "FMA", 3) == 0) {
+        ExecFma(s, line_number);
+    }
+    else if (line_length == 4 && strncmp(buffer, "SQR", 3) == 0) {
+        ExecSqr(s, line_number);
+    }
     else if (line_length == 6 && strncmp(buffer, "IS_EQ", 5) == 0) {
         ExecIsEq(s, line_number);
     }
     else if (line_length == 4 && strncmp(buffer, "DEG", 3) == 0) {
         ExecDeg(s, line_number);
     }
+    else if (line_length == 8 && strncmp(buffer, "DEG_ALL", 7) == 0) {
+        ExecDegAll(s, line_number);
+    }
     else if (strncmp(buffer, "DEG_BY", 6) == 0) {
         if (line_length > 7 && buffer[6] != ' ') {
             CommandErr(line_number);
@@ -306,6 +388,21 @@ void ParseInstruction(Stack *s, char *buffer, ssize_t line_length, int line_numb
             }
         }
     }
+    else if (strncmp(buffer, "AT_VAR", 6) == 0) {
+        unsigned long idx;
+        long x;
+        if (line_length > 7 && buffer[6] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 10 || buffer[6] != ' ' ||
+                 line_length - 1 != (ssize_t) strlen(buffer) ||
+                 !ConvertVarArgs(&buffer[7], &idx, &x)) {
+            AtVarErr(line_number);
+        }
+        else {
+            ExecAtVar(s, idx, x, line_number);
+        }
+    }
     else if (strncmp(buffer, "AT", 2) == 0) {
         if (line_length > 3 && buffer[2] != ' ') {
             CommandErr(line_number);
@@ -335,6 +432,20 @@ void ParseInstruction(Stack *s, char *buffer, ssize_t line_length, int line_numb
     else if (line_length == 4 && strncmp(buffer, "POP", 3) == 0) {
         ExecPop(s, line_number);
     }
+    else if (strncmp(buffer, "COMPOSE_TRUNC", 13) == 0) {
+        unsigned long n, deg;
+        if (line_length > 14 && buffer[13] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 17 || buffer[13] != ' ' ||
+                 line_length - 1 != (ssize_t) strlen(buffer) ||
+                 !ConvertTwoArgs(&buffer[14], &n, &deg)) {
+            ComposeTruncErr(line_number);
+        }
+        else {
+            ExecComposeTrunc(s, n, deg, line_number);
+        }
+    }
     else if (strncmp(buffer, "COMPOSE", 7) == 0) {
         if (line_length > 8 && buffer[7] != ' ') {
             CommandErr(line_number);
@@ -358,11 +469,170 @@ void ParseInstruction(Stack *s, char *buffer, ssize_t line_length, int line_numb
             }
         }
     }
+    else if (strncmp(buffer, "MOD", 3) == 0) {
+        if (line_length > 4 && buffer[3] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 6 || buffer[3] != ' ') {
+            ModErr(line_number);
+        }
+        else if (line_length == 6 && buffer[4] == '0') {
+            ExecMod(s, 0, line_number);
+        }
+        else if (line_length - 1 != (ssize_t) strlen(buffer)) {
+            ModErr(line_number);
+        }
+        else {
+            unsigned long m = ConvertDegByOrComposeArg(&buffer[4]);
+            if (m == 0) {
+                ModErr(line_number);
+            }
+            else {
+                ExecMod(s, m, line_number);
+            }
+        }
+    }
+    else if (strncmp(buffer, "EXACT", 5) == 0) {
+        if (line_length > 6 && buffer[5] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 8 || buffer[5] != ' ') {
+            ExactErr(line_number);
+        }
+        else if (line_length == 8 && buffer[6] == '0') {
+            ExecExact(0, line_number);
+        }
+        else if (line_length - 1 != (ssize_t) strlen(buffer)) {
+            ExactErr(line_number);
+        }
+        else {
+            unsigned long exact = ConvertDegByOrComposeArg(&buffer[6]);
+            if (exact == 0) {
+                ExactErr(line_number);
+            }
+            else {
+                ExecExact(exact, line_number);
+            }
+        }
+    }
+    else if (strncmp(buffer, "SUBST", 5) == 0) {
+        if (line_length > 6 && buffer[5] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 8 || buffer[5] != ' ') {
+            SubstErr(line_number);
+        }
+        else if (line_length == 8 && buffer[6] == '0') {
+            ExecSubst(s, 0, line_number);
+        }
+        else if (line_length - 1 != (ssize_t) strlen(buffer)) {
+            SubstErr(line_number);
+        }
+        else {
+            unsigned long idx = ConvertDegByOrComposeArg(&buffer[6]);
+            if (idx == 0) {
+                SubstErr(line_number);
+            }
+            else {
+                ExecSubst(s, idx, line_number);
+            }
+        }
+    }
+    else if (strncmp(buffer, "SHIFT", 5) == 0) {
+        unsigned long idx;
+        long c;
+        if (line_length > 6 && buffer[5] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 9 || buffer[5] != ' ' ||
+                 line_length - 1 != (ssize_t) strlen(buffer) ||
+                 !ConvertVarArgs(&buffer[6], &idx, &c)) {
+            ShiftErr(line_number);
+        }
+        else {
+            ExecShift(s, idx, c, line_number);
+        }
+    }
+    else if (strncmp(buffer, "MUL_TRUNC", 9) == 0) {
+        if (line_length > 10 && buffer[9] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 12 || buffer[9] != ' ') {
+            MulTruncErr(line_number);
+        }
+        else if (line_length == 12 && buffer[10] == '0') {
+            ExecMulTrunc(s, 0, line_number);
+        }
+        else if (line_length - 1 != (ssize_t) strlen(buffer)) {
+            MulTruncErr(line_number);
+        }
+        else {
+            unsigned long deg = ConvertDegByOrComposeArg(&buffer[10]);
+            if (deg == 0) {
+                MulTruncErr(line_number);
+            }
+            else {
+                ExecMulTrunc(s, deg, line_number);
+            }
+        }
+    }
+    else if (strncmp(buffer, "POW_TRUNC", 9) == 0) {
+        unsigned long n, deg;
+        if (line_length > 10 && buffer[9] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 13 || buffer[9] != ' ' ||
+                 line_length - 1 != (ssize_t) strlen(buffer) ||
+                 !ConvertTwoArgs(&buffer[10], &n, &deg)) {
+            PowTruncErr(line_number);
+        }
+        else {
+            ExecPowTrunc(s, n, deg, line_number);
+        }
+    }
+    else if (strncmp(buffer, "POW", 3) == 0) {
+        if (line_length > 4 && buffer[3] != ' ') {
+            CommandErr(line_number);
+        }
+        else if (line_length < 6 || buffer[3] != ' ') {
+            PowErr(line_number);
+        }
+        else if (line_length == 6 && buffer[4] == '0') {
+            ExecPow(s, 0, line_number);
+        }
+        else if (line_length - 1 != (ssize_t) strlen(buffer)) {
+            PowErr(line_number);
+        }
+        else {
+            unsigned long n = ConvertDegByOrComposeArg(&buffer[4]);
+            if (n == 0) {
+                PowErr(line_number);
+            }
+            else {
+                ExecPow(s, n, line_number);
+            }
+        }
+    }
     else {
         CommandErr(line_number);
     }
 }
 
+/**
+ * Wrzuca wielomian na stos, sprowadzając jego współczynniki do reszt modulo
+ * moduł ustawiony poleceniem MOD.
+ * @param[in] p : wielomian
+ * @param[in] s : stos
+ */
+static void PushReduced(Poly *p, Stack *s) {
+    if (PolyGetModulus() != 0) {
+        Poly r = PolyReduce(p);
+        PolyDestroy(p);
+        *p = r;
+    }
+    StackPush(p, s);
+}
+
 /**
  * Konwertuje napis na wielomian i wrzuca go na stos. Jeśli wykryje jakiś błąd
  * podczas konwersji to go wypisuje.
@@ -372,7 +642,11 @@ void ParseInstruction(Stack *s, char *buffer, ssize_t line_length, int line_numb
  * @param[in] line_number : numer wiersza
  */
 void ParsePoly(Stack *s, char *buffer, ssize_t line_length, int line_number) {
-    if (IsPolyCoeff(buffer, line_length)) {
+    if (IsPolyCoeff(buffer, line_length) && PolyGetExact()) {
+        Poly p = PolyCoeffFromString(buffer, NULL);
+        PushReduced(&p, s);
+    }
+    else if (IsPolyCoeff(buffer, line_length)) {
         char *remainder;
         long coeff = strtol(buffer, &remainder, DEC);
         if (errno == ERANGE || remainder[0] != '\0') {
@@ -381,7 +655,7 @@ void ParsePoly(Stack *s, char *buffer, ssize_t line_length, int line_number) {
         }
         else {
             Poly p = PolyFromCoeff(coeff);
-            StackPush(&p, s);
+            PushReduced(&p, s);
         }
     }
     else if (buffer[0] == '(' && IsPolyCorrect(buffer, line_length)) {
@@ -394,7 +668,7 @@ void ParsePoly(Stack *s, char *buffer, ssize_t line_length, int line_number) {
             PolyErr(line_number);
         }
         else {
-            StackPush(&p, s);
+            PushReduced(&p, s);
         }
     }
     else {
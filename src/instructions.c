@@ -32,6 +32,42 @@ void ComposeErr(int line_number) {
     fprintf(stderr, "ERROR %d COMPOSE WRONG PARAMETER\n", line_number);
 }
 
+void ModErr(int line_number) {
+    fprintf(stderr, "ERROR %d MOD WRONG VALUE\n", line_number);
+}
+
+void ExactErr(int line_number) {
+    fprintf(stderr, "ERROR %d EXACT WRONG VALUE\n", line_number);
+}
+
+void PowErr(int line_number) {
+    fprintf(stderr, "ERROR %d POW WRONG EXPONENT\n", line_number);
+}
+
+void MulTruncErr(int line_number) {
+    fprintf(stderr, "ERROR %d MUL_TRUNC WRONG DEGREE\n", line_number);
+}
+
+void PowTruncErr(int line_number) {
+    fprintf(stderr, "ERROR %d POW_TRUNC WRONG PARAMETER\n", line_number);
+}
+
+void ComposeTruncErr(int line_number) {
+    fprintf(stderr, "ERROR %d COMPOSE_TRUNC WRONG PARAMETER\n", line_number);
+}
+
+void ShiftErr(int line_number) {
+    fprintf(stderr, "ERROR %d SHIFT WRONG PARAMETER\n", line_number);
+}
+
+void SubstErr(int line_number) {
+    fprintf(stderr, "ERROR %d SUBST WRONG VARIABLE\n", line_number);
+}
+
+void AtVarErr(int line_number) {
+    fprintf(stderr, "ERROR %d AT_VAR WRONG PARAMETER\n", line_number);
+}
+
 void Zero(Stack *s) {
     Poly p = PolyZero();
     StackPush(&p, s);
@@ -64,18 +100,12 @@ void Add(Stack *s) {
 
 void Mul(Stack *s) {
     Poly p = StackPop(s);
-    Poly q = StackPop(s);
-    Poly r = PolyMul(&p, &q);
-    StackPush(&r, s);
+    PolyMulInPlace(&s->array[s->pick - 1], &p);
     PolyDestroy(&p);
-    PolyDestroy(&q);
 }
 
 void Neg(Stack *s) {
-    Poly p = StackPop(s);
-    Poly q = PolyNeg(&p);
-    StackPush(&q, s);
-    PolyDestroy(&p);
+    PolyNegInPlace(&s->array[s->pick - 1]);
 }
 
 void Sub(Stack *s) {
@@ -87,6 +117,21 @@ void Sub(Stack *s) {
     PolyDestroy(&q);
 }
 
+void Fma(Stack *s) {
+    Poly p = StackPop(s);
+    Poly q = StackPop(s);
+    PolyFmaAssign(&s->array[s->pick - 1], &p, &q);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+}
+
+void Sqr(Stack *s) {
+    Poly p = StackPop(s);
+    Poly q = PolySqr(&p);
+    StackPush(&q, s);
+    PolyDestroy(&p);
+}
+
 void IsEq(Stack *s) {
     Poly p = StackTop(s);
     Poly q = s->array[s->pick - 2];
@@ -103,6 +148,31 @@ void DegBy(Stack *s, size_t idx) {
     printf("%d\n", PolyDegBy(&p, idx));
 }
 
+void DegAll(Stack *s) {
+    Poly p = StackTop(s);
+    poly_exp_t buffer[DEG_ALL_BUFFER];
+    poly_exp_t *degs = buffer;
+    poly_exp_t deg;
+    size_t vars = PolyDegVector(&p, buffer, DEG_ALL_BUFFER, &deg);
+
+    // drugie przejście tylko wtedy, gdy zmiennych jest więcej niż miejsca
+    if (vars > DEG_ALL_BUFFER) {
+        degs = malloc(vars * sizeof(poly_exp_t));
+        CHECK_PTR(degs);
+        PolyDegVector(&p, degs, vars, NULL);
+    }
+
+    printf("%d %zu", deg, vars);
+    for (size_t i = 0; i < vars; i++) {
+        printf(" %d", degs[i]);
+    }
+    putchar('\n');
+
+    if (degs != buffer) {
+        free(degs);
+    }
+}
+
 void At(Stack *s, poly_coeff_t x) {
     Poly p = StackPop(s);
     Poly q = PolyAt(&p, x);
@@ -115,9 +185,16 @@ void At(Stack *s, poly_coeff_t x) {
  * @param[in] p : wielomian
  */
 static void PrintPoly(Poly *p) {
-    if (PolyIsDeepCoeff(p)) {
-        poly_coeff_t coeff = PolyGetDeepCoeff(p);
-        printf("%ld", coeff);
+    if (!PolyIsCoeff(p) && PolyIsDeepCoeff(p)) { // (c, 0) spoza biblioteki
+        PrintPoly(&p->arr[0].p);
+    }
+    else if (PolyIsBigCoeff(p)) {
+        char *str = PolyCoeffToString(p);
+        printf("%s", str);
+        free(str);
+    }
+    else if (PolyIsCoeff(p)) {
+        printf("%ld", p->coeff);
     }
     else {
         for (size_t i = 0; i < p->size; i++) {
@@ -161,6 +238,84 @@ void Compose(Stack *s, size_t k) {
     free(q);
 }
 
+void Mod(Stack *s, poly_coeff_t m) {
+    PolySetModulus(m);
+    if (m != 0) {
+        for (size_t i = 0; i < s->pick; i++) {
+            Poly p = PolyReduce(&s->array[i]);
+            PolyDestroy(&s->array[i]);
+            s->array[i] = p;
+        }
+    }
+}
+
+void Exact(bool exact) {
+    PolySetExact(exact);
+}
+
+void Pow(Stack *s, poly_exp_t n) {
+    Poly p = StackPop(s);
+    Poly q = PolyPow(&p, n);
+    StackPush(&q, s);
+    PolyDestroy(&p);
+}
+
+void MulTrunc(Stack *s, poly_exp_t deg) {
+    Poly p = StackPop(s);
+    Poly q = StackPop(s);
+    Poly r = PolyMulTrunc(&q, &p, deg);
+    StackPush(&r, s);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+}
+
+void PowTrunc(Stack *s, poly_exp_t n, poly_exp_t deg) {
+    Poly p = StackPop(s);
+    Poly q = PolyPowTrunc(&p, n, deg);
+    StackPush(&q, s);
+    PolyDestroy(&p);
+}
+
+void ComposeTrunc(Stack *s, size_t k, poly_exp_t deg) {
+    Poly p = StackPop(s);
+    Poly *q = malloc(k * sizeof(Poly));
+    CHECK_PTR(q);
+    for (size_t i = 0; i < k; i++) {
+        q[k - 1 - i] = StackPop(s);
+    }
+
+    Poly r = PolyComposeTrunc(&p, k, q, deg);
+    StackPush(&r, s);
+    PolyDestroy(&p);
+    for (size_t i = 0; i < k; i++) {
+        PolyDestroy(&q[i]);
+    }
+    free(q);
+}
+
+void Shift(Stack *s, size_t idx, poly_coeff_t c) {
+    Poly p = StackPop(s);
+    Poly q = PolyShift(&p, idx, c);
+    StackPush(&q, s);
+    PolyDestroy(&p);
+}
+
+void Subst(Stack *s, size_t idx) {
+    Poly p = StackPop(s);
+    Poly q = StackPop(s);
+    Poly r = PolySubstVar(&p, idx, &q);
+    StackPush(&r, s);
+    PolyDestroy(&p);
+    PolyDestroy(&q);
+}
+
+void AtVar(Stack *s, size_t idx, poly_coeff_t x) {
+    Poly p = StackPop(s);
+    Poly q = PolyAtVar(&p, idx, x);
+    StackPush(&q, s);
+    PolyDestroy(&p);
+}
+
 void ExecZero(Stack *s) {
     if (StackIsFull(s)) {
         ExtendStack(s);
@@ -233,6 +388,24 @@ void ExecSub(Stack *s, int line_number) {
     }
 }
 
+void ExecFma(Stack *s, int line_number) {
+    if (s->pick < 3) {
+        UnderflowErr(line_number);
+    }
+    else {
+        Fma(s);
+    }
+}
+
+void ExecSqr(Stack *s, int line_number) {
+    if (StackIsEmpty(s)) {
+        UnderflowErr(line_number);
+    }
+    else {
+        Sqr(s);
+    }
+}
+
 void ExecIsEq(Stack *s, int line_number) {
     if (s->pick < 2) {
         UnderflowErr(line_number);
@@ -251,6 +424,15 @@ void ExecDeg(Stack *s, int line_number) {
     }
 }
 
+void ExecDegAll(Stack *s, int line_number) {
+    if (StackIsEmpty(s)) {
+        UnderflowErr(line_number);
+    }
+    else {
+        DegAll(s);
+    }
+}
+
 void ExecDegBy(Stack *s, size_t idx, int line_number) {
     if (StackIsEmpty(s)) {
         UnderflowErr(line_number);
@@ -294,4 +476,107 @@ void ExecCompose(Stack *s, size_t k, int line_number) {
     else {
         Compose(s, k);
     }
+}
+
+void ExecMod(Stack *s, unsigned long m, int line_number) {
+    if (m != 0 && (m >= POLY_MAX_MODULUS || !PolyIsPrime((poly_coeff_t) m))) {
+        ModErr(line_number);
+    }
+    else {
+        Mod(s, (poly_coeff_t) m);
+    }
+}
+
+void ExecExact(unsigned long exact, int line_number) {
+    if (exact > 1) {
+        ExactErr(line_number);
+    }
+    else {
+        Exact(exact == 1);
+    }
+}
+
+/**
+ * Sprawdza, czy liczba mieści się w typie wykładników.
+ * @param[in] n : liczba
+ * @return czy @p n jest poprawnym wykładnikiem
+ */
+static bool FitsExp(unsigned long n) {
+    return (unsigned long) (poly_exp_t) n == n && (poly_exp_t) n >= 0;
+}
+
+void ExecPow(Stack *s, unsigned long n, int line_number) {
+    if (!FitsExp(n)) {
+        PowErr(line_number);
+    }
+    else if (StackIsEmpty(s)) {
+        UnderflowErr(line_number);
+    }
+    else {
+        Pow(s, (poly_exp_t) n);
+    }
+}
+
+void ExecMulTrunc(Stack *s, unsigned long deg, int line_number) {
+    if (!FitsExp(deg)) {
+        MulTruncErr(line_number);
+    }
+    else if (s->pick < 2) {
+        UnderflowErr(line_number);
+    }
+    else {
+        MulTrunc(s, (poly_exp_t) deg);
+    }
+}
+
+void ExecPowTrunc(Stack *s, unsigned long n, unsigned long deg,
+                  int line_number) {
+    if (!FitsExp(n) || !FitsExp(deg)) {
+        PowTruncErr(line_number);
+    }
+    else if (StackIsEmpty(s)) {
+        UnderflowErr(line_number);
+    }
+    else {
+        PowTrunc(s, (poly_exp_t) n, (poly_exp_t) deg);
+    }
+}
+
+void ExecComposeTrunc(Stack *s, size_t k, unsigned long deg, int line_number) {
+    if (!FitsExp(deg)) {
+        ComposeTruncErr(line_number);
+    }
+    else if (s->pick == 0 || s->pick - 1 < k) {
+        UnderflowErr(line_number);
+    }
+    else {
+        ComposeTrunc(s, k, (poly_exp_t) deg);
+    }
+}
+
+void ExecShift(Stack *s, size_t idx, poly_coeff_t c, int line_number) {
+    if (StackIsEmpty(s)) {
+        UnderflowErr(line_number);
+    }
+    else {
+        Shift(s, idx, c);
+    }
+}
+
+void ExecSubst(Stack *s, size_t idx, int line_number) {
+    if (s->pick < 2) {
+        UnderflowErr(line_number);
+    }
+    else {
+        Subst(s, idx);
+    }
+}
+
+void ExecAtVar(Stack *s, size_t idx, poly_coeff_t x, int line_number) {
+    if (StackIsEmpty(s)) {
+        UnderflowErr(line_number);
+    }
+    else {
+        AtVar(s, idx, x);
+    }
 }
\ No newline at end of file
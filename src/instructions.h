@@ -12,6 +12,12 @@
 #include "stack.h"
 #include <stdio.h>
 
+/**
+ * Liczba zmiennych, dla których DEG_ALL wylicza stopnie w jednym przejściu
+ * wielomianu, bez alokacji.
+ */
+#define DEG_ALL_BUFFER 16
+
 /**
  * Jeśli program wykryje niepoprawną nazwę polecenia, wypisuje błąd.
  * @param[in] line_number : numer wiersza
@@ -51,6 +57,69 @@ void PolyErr(int line_number);
  */
 void ComposeErr(int line_number);
 
+/**
+ * Jeśli w poleceniu MOD nie podano parametru lub jest on niepoprawny,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void ModErr(int line_number);
+
+/**
+ * Jeśli w poleceniu EXACT nie podano parametru lub jest on różny od 0 i 1,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void ExactErr(int line_number);
+
+/**
+ * Jeśli w poleceniu POW nie podano wykładnika lub jest on niepoprawny,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void PowErr(int line_number);
+
+/**
+ * Jeśli w poleceniu MUL_TRUNC nie podano stopnia lub jest on niepoprawny,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void MulTruncErr(int line_number);
+
+/**
+ * Jeśli w poleceniu POW_TRUNC nie podano parametrów lub są one niepoprawne,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void PowTruncErr(int line_number);
+
+/**
+ * Jeśli w poleceniu COMPOSE_TRUNC nie podano parametrów lub są one
+ * niepoprawne, program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void ComposeTruncErr(int line_number);
+
+/**
+ * Jeśli w poleceniu SHIFT nie podano parametrów lub są one niepoprawne,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void ShiftErr(int line_number);
+
+/**
+ * Jeśli w poleceniu SUBST nie podano parametru lub jest on niepoprawny,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void SubstErr(int line_number);
+
+/**
+ * Jeśli w poleceniu AT_VAR nie podano parametrów lub są one niepoprawne,
+ * program wypisuje błąd.
+ * @param[in] line_number : numer wiersza
+ */
+void AtVarErr(int line_number);
+
 /**
  * Wstawia na wierzchołek stosu wielomian tożsamościowo równy zeru
  * @param[in] s : stos
@@ -104,6 +173,19 @@ void Neg(Stack *s);
  */
 void Sub(Stack *s);
 
+/**
+ * Zdejmuje z wierzchołka stosu dwa wielomiany i dodaje ich iloczyn do
+ * trzeciego wielomianu, który zostaje na wierzchołku stosu.
+ * @param[in] s : stos
+ */
+void Fma(Stack *s);
+
+/**
+ * Podnosi do kwadratu wielomian z wierzchołka stosu.
+ * @param[in] s : stos
+ */
+void Sqr(Stack *s);
+
 /**
  * Sprawdza czy dwa wielomiany na wierzchu stosu są równe – wypisuje na
  * standardowe wyjście 0 lub 1.
@@ -126,6 +208,14 @@ void Deg(Stack *s);
  */
 void DegBy(Stack *s, size_t idx);
 
+/**
+ * Wypisuje na standardowe wyjście w jednym wierszu stopień wielomianu
+ * z wierzchołka stosu, liczbę jego zmiennych @f$n@f$ oraz stopnie ze względu
+ * na zmienne @f$x_0, \ldots, x_{n-1}@f$.
+ * @param[in] s : stos
+ */
+void DegAll(Stack *s);
+
 /**
  * Wylicza wartość wielomianu w punkcie @p x, usuwa wielomian z wierzchołka
  * i wstawia na stos wynik operacji.
@@ -154,6 +244,82 @@ void Pop(Stack *s);
  */
 void Compose(Stack *s, size_t k);
 
+/**
+ * Ustawia moduł @p m arytmetyki współczynników i sprowadza współczynniki
+ * wszystkich wielomianów na stosie do reszt modulo @p m. Moduł 0 przywraca
+ * zwykłą arytmetykę.
+ * @param[in] s : stos
+ * @param[in] m : moduł
+ */
+void Mod(Stack *s, poly_coeff_t m);
+
+/**
+ * Włącza lub wyłącza tryb dokładny, w którym przepełnione współczynniki
+ * stają się liczbami wielkimi, a wczytywane współczynniki mogą mieć
+ * dowolnie wiele cyfr. Wielomiany na stosie się nie zmieniają.
+ * @param[in] exact : czy włączyć tryb dokładny
+ */
+void Exact(bool exact);
+
+/**
+ * Podnosi wielomian z wierzchołka stosu do potęgi @p n.
+ * @param[in] s : stos
+ * @param[in] n : wykładnik
+ */
+void Pow(Stack *s, poly_exp_t n);
+
+/**
+ * Zdejmuje dwa wielomiany z wierzchołka stosu i wstawia ich iloczyn
+ * bez jednomianów o stopniu łącznym większym niż @p deg.
+ * @param[in] s : stos
+ * @param[in] deg : największy zachowany stopień łączny
+ */
+void MulTrunc(Stack *s, poly_exp_t deg);
+
+/**
+ * Podnosi wielomian z wierzchołka stosu do potęgi @p n, pomijając
+ * jednomiany o stopniu łącznym większym niż @p deg.
+ * @param[in] s : stos
+ * @param[in] n : wykładnik
+ * @param[in] deg : największy zachowany stopień łączny
+ */
+void PowTrunc(Stack *s, poly_exp_t n, poly_exp_t deg);
+
+/**
+ * Działa jak Compose, ale pomija jednomiany wyniku o stopniu łącznym
+ * większym niż @p deg.
+ * @param[in] s : stos
+ * @param[in] k : parametr
+ * @param[in] deg : największy zachowany stopień łączny
+ */
+void ComposeTrunc(Stack *s, size_t k, poly_exp_t deg);
+
+/**
+ * Podstawia @f$x_{idx} + c@f$ za zmienną @f$x_{idx}@f$ w wielomianie
+ * z wierzchołka stosu.
+ * @param[in] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] c : przesunięcie
+ */
+void Shift(Stack *s, size_t idx, poly_coeff_t c);
+
+/**
+ * Zdejmuje z wierzchołka stosu wielomian @f$p@f$, a spod niego wielomian
+ * @f$q@f$, i wstawia @f$p@f$ z @f$q@f$ podstawionym za zmienną
+ * @f$x_{idx}@f$.
+ * @param[in] s : stos
+ * @param[in] idx : indeks zmiennej
+ */
+void Subst(Stack *s, size_t idx);
+
+/**
+ * Wylicza wartość wielomianu z wierzchołka stosu dla @f$x_{idx} = x@f$.
+ * @param[in] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] x : wartość zmiennej
+ */
+void AtVar(Stack *s, size_t idx, poly_coeff_t x);
+
 /**
  * Wywołuje funkcję Zero.
  * @param[in] s : stos
@@ -210,6 +376,20 @@ void ExecNeg(Stack *s, int line_number);
  */
 void ExecSub(Stack *s, int line_number);
 
+/**
+ * Wywołuje funkcję Fma, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] line_number : numer wiersza
+ */
+void ExecFma(Stack *s, int line_number);
+
+/**
+ * Wywołuje funkcję Sqr, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] line_number : numer wiersza
+ */
+void ExecSqr(Stack *s, int line_number);
+
 /**
  * Wywołuje funkcję IsEq, jeśli jest to możliwe.
  * @param[in] s : stos
@@ -224,6 +404,13 @@ void ExecIsEq(Stack *s, int line_number);
  */
 void ExecDeg(Stack *s, int line_number);
 
+/**
+ * Wywołuje funkcję DegAll, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] line_number : numer wiersza
+ */
+void ExecDegAll(Stack *s, int line_number);
+
 /**
  * Wywołuje funkcję DegBy, jeśli jest to możliwe.
  * @param[in] s : stos
@@ -262,4 +449,80 @@ void ExecPop(Stack *s, int line_number);
  */
 void ExecCompose(Stack *s, size_t k, int line_number);
 
+/**
+ * Wywołuje funkcję Mod, jeśli moduł jest zerem lub liczbą pierwszą.
+ * @param[in] s : stos
+ * @param[in] m : moduł
+ * @param[in] line_number : numer wiersza
+ */
+void ExecMod(Stack *s, unsigned long m, int line_number);
+
+/**
+ * Wywołuje funkcję Exact, jeśli parametr jest równy 0 lub 1.
+ * @param[in] exact : parametr
+ * @param[in] line_number : numer wiersza
+ */
+void ExecExact(unsigned long exact, int line_number);
+
+/**
+ * Wywołuje funkcję Pow, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] n : wykładnik
+ * @param[in] line_number : numer wiersza
+ */
+void ExecPow(Stack *s, unsigned long n, int line_number);
+
+/**
+ * Wywołuje funkcję MulTrunc, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] deg : największy zachowany stopień łączny
+ * @param[in] line_number : numer wiersza
+ */
+void ExecMulTrunc(Stack *s, unsigned long deg, int line_number);
+
+/**
+ * Wywołuje funkcję PowTrunc, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] n : wykładnik
+ * @param[in] deg : największy zachowany stopień łączny
+ * @param[in] line_number : numer wiersza
+ */
+void ExecPowTrunc(Stack *s, unsigned long n, unsigned long deg,
+                  int line_number);
+
+/**
+ * Wywołuje funkcję ComposeTrunc, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] k : parametr
+ * @param[in] deg : największy zachowany stopień łączny
+ * @param[in] line_number : numer wiersza
+ */
+void ExecComposeTrunc(Stack *s, size_t k, unsigned long deg, int line_number);
+
+/**
+ * Wywołuje funkcję Shift, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] c : przesunięcie
+ * @param[in] line_number : numer wiersza
+ */
+void ExecShift(Stack *s, size_t idx, poly_coeff_t c, int line_number);
+
+/**
+ * Wywołuje funkcję Subst, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] line_number : numer wiersza
+ */
+void ExecSubst(Stack *s, size_t idx, int line_number);
+
+/**
+ * Wywołuje funkcję AtVar, jeśli jest to możliwe.
+ * @param[in] s : stos
+ * @param[in] idx : indeks zmiennej
+ * @param[in] x : wartość zmiennej
+ * @param[in] line_number : numer wiersza
+ */
+void ExecAtVar(Stack *s, size_t idx, poly_coeff_t x, int line_number);
+
 #endif
\ No newline at end of file
@@ -7,627 +7,3509 @@
 */
 
 #include "poly.h"
+#include <string.h>
+
+/** Liczba pierwsza @f$2^{61} - 1@f$, modulo której wyliczane są wartości
+ * wielomianów w losowych punktach. */
+#define EVAL_PRIME ((UINT64_C(1) << 61) - 1)
+
+/** Ziarno punktu, w którym PolyHash wylicza wartości wielomianów. */
+#define HASH_SEED UINT64_C(0x2545F4914F6CDD1D)
+
+/** Najmniejsza liczba jednomianów sortowana pozycyjnie zamiast przez qsort. */
+#define RADIX_SORT_MIN 64
+
+/** Czy od ostatniego wywołania PolyCoeffOverflow wystąpiło przepełnienie. */
+static bool coeff_overflow = false;
+
+/** Czy przepełnione współczynniki są zamieniane na liczby wielkie. */
+static bool exact_coeffs = false;
+
+/** Moduł arytmetyki współczynników (0, jeśli arytmetyka nie jest modularna). */
+static uint64_t modulus = 0;
+
+/** Liczba bitów @f$k@f$ modułu. */
+static unsigned modulus_bits = 0;
+
+/** Stała redukcji Barretta @f$\lfloor 2^{2k} / m \rfloor@f$. */
+static uint64_t barrett_mu = 0;
+
+/**
+ * Sprowadza współczynnik do przedziału @f$[0, m)@f$, gdzie @f$m@f$ jest
+ * ustawionym modułem. Współczynniki wyliczone w trybie modularnym już są
+ * w tym przedziale, więc dzielenie wykonywane jest tylko dla pozostałych.
+ * @param[in] a : współczynnik
+ * @return @f$a \bmod m@f$
+ */
+static inline uint64_t CoeffToResidue(poly_coeff_t a) {
+    if (a >= 0 && a < (poly_coeff_t) modulus) {
+        return (uint64_t) a;
+    }
+
+    poly_coeff_t r = a % (poly_coeff_t) modulus;
+    return r < 0 ? (uint64_t) r + modulus : (uint64_t) r;
+}
+
+/**
+ * Redukuje liczbę @f$x < m^2@f$ modulo @f$m@f$ metodą Barretta, używając
+ * dwóch mnożeń zamiast dzielenia.
+ * @param[in] x : liczba mniejsza od @f$m^2@f$
+ * @return @f$x \bmod m@f$
+ */
+static inline uint64_t BarrettReduce(unsigned __int128 x) {
+    uint64_t q = (uint64_t) (x >> (modulus_bits - 1));
+    q = (uint64_t) (((unsigned __int128) q * barrett_mu) >> (modulus_bits + 1));
+    uint64_t r = (uint64_t) x - q * modulus;
+
+    while (r >= modulus) {
+        r -= modulus;
+    }
+
+    return r;
+}
+
+/**
+ * Dodaje dwa współczynniki. W trybie modularnym wynik jest resztą modulo
+ * ustawiony moduł. W przeciwnym razie przy przepełnieniu wynik jest brany
+ * modulo @f$2^{64}@f$, a przepełnienie zapamiętywane dla PolyCoeffOverflow.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a + b@f$
+ */
+static inline poly_coeff_t CoeffAdd(poly_coeff_t a, poly_coeff_t b) {
+    poly_coeff_t result;
+
+    if (modulus != 0) {
+        uint64_t sum = CoeffToResidue(a) + CoeffToResidue(b);
+        return (poly_coeff_t) (sum >= modulus ? sum - modulus : sum);
+    }
+    else if (__builtin_add_overflow(a, b, &result)) {
+        coeff_overflow = true;
+    }
+
+    return result;
+}
+
+/**
+ * Mnoży dwa współczynniki. W trybie modularnym wynik jest resztą modulo
+ * ustawiony moduł. W przeciwnym razie przy przepełnieniu wynik jest brany
+ * modulo @f$2^{64}@f$, a przepełnienie zapamiętywane dla PolyCoeffOverflow.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a \cdot b@f$
+ */
+static inline poly_coeff_t CoeffMul(poly_coeff_t a, poly_coeff_t b) {
+    poly_coeff_t result;
+
+    if (modulus != 0) {
+        return (poly_coeff_t) BarrettReduce(
+            (unsigned __int128) CoeffToResidue(a) * CoeffToResidue(b));
+    }
+    else if (__builtin_mul_overflow(a, b, &result)) {
+        coeff_overflow = true;
+    }
+
+    return result;
+}
+
+/**
+ * Zmienia znak współczynnika. W trybie modularnym wynik jest resztą modulo
+ * ustawiony moduł. W przeciwnym razie przepełnienie (dla najmniejszej
+ * wartości typu) jest zapamiętywane dla PolyCoeffOverflow.
+ * @param[in] a : współczynnik
+ * @return @f$-a@f$
+ */
+static inline poly_coeff_t CoeffNeg(poly_coeff_t a) {
+    poly_coeff_t result;
+
+    if (modulus != 0) {
+        uint64_t r = CoeffToResidue(a);
+        return (poly_coeff_t) (r == 0 ? 0 : modulus - r);
+    }
+    else if (__builtin_sub_overflow(0, a, &result)) {
+        coeff_overflow = true;
+    }
+
+    return result;
+}
+
+/**
+ * Liczba wielka, czyli współczynnik, który nie mieści się w typie
+ * poly_coeff_t. Wartość bezwzględna zapisana jest cyframi o podstawie
+ * @f$2^{64}@f$, od najmniej znaczącej, a najbardziej znacząca cyfra jest
+ * niezerowa. Wielomian będący liczbą wielką ma `size == 0`, a `arr` wskazuje
+ * na tę strukturę.
+ */
+typedef struct BigCoeff {
+    size_t len; ///< liczba cyfr
+    bool negative; ///< czy liczba jest ujemna
+    uint64_t digits[]; ///< cyfry wartości bezwzględnej
+} BigCoeff;
+
+/** Największa wartość bezwzględna dodatniego współczynnika typu poly_coeff_t. */
+#define COEFF_MAX_MAGNITUDE \
+    ((~(unsigned __int128) 0) >> (129 - 8 * sizeof(poly_coeff_t)))
+
+/** Liczba cyfr, w których mieści się wartość bezwzględna współczynnika. */
+#define COEFF_DIGITS 2
+
+/** Największa potęga dziesięciu mieszcząca się w cyfrze liczby wielkiej. */
+#define DECIMAL_CHUNK UINT64_C(10000000000000000000)
+
+/** Liczba cyfr dziesiętnych w DECIMAL_CHUNK. */
+#define DECIMAL_CHUNK_DIGITS 19
+
+/**
+ * Wartość współczynnika rozłożona na znak i cyfry. Cyfry współczynnika
+ * będącego liczbą przechowywane są w polu `word`, bez alokacji, więc
+ * strukturę przekazuje się tylko przez wskaźnik.
+ */
+typedef struct CoeffDigits {
+    const uint64_t *digits; ///< cyfry wartości bezwzględnej
+    size_t len; ///< liczba cyfr
+    bool negative; ///< czy liczba jest ujemna
+    uint64_t word[COEFF_DIGITS]; ///< cyfry współczynnika będącego liczbą
+} CoeffDigits;
+
+/**
+ * Sprawdza, czy współczynnik jest liczbą typu poly_coeff_t, a nie liczbą
+ * wielką.
+ * @param[in] c : współczynnik
+ * @return Czy współczynnik jest liczbą?
+ */
+static inline bool CoeffIsWord(const Poly *c) {
+    return c->arr == NULL;
+}
+
+/**
+ * Rozkłada współczynnik na znak i cyfry.
+ * @param[in] c : współczynnik
+ * @param[out] d : znak i cyfry współczynnika
+ */
+static void CoeffGetDigits(const Poly *c, CoeffDigits *d) {
+    if (CoeffIsWord(c)) {
+        unsigned __int128 magnitude = c->coeff < 0
+                                      ? -(unsigned __int128) c->coeff
+                                      : (unsigned __int128) c->coeff;
+        d->word[0] = (uint64_t) magnitude;
+        d->word[1] = (uint64_t) (magnitude >> 64);
+        d->len = d->word[1] != 0 ? 2 : d->word[0] != 0 ? 1 : 0;
+        d->negative = c->coeff < 0;
+        d->digits = d->word;
+    }
+    else {
+        const BigCoeff *big = (const BigCoeff *) c->arr;
+        d->digits = big->digits;
+        d->len = big->len;
+        d->negative = big->negative;
+    }
+}
+
+/**
+ * Alokuje nieujemną liczbę wielką o @p len cyfrach.
+ * @param[in] len : liczba cyfr
+ * @return liczba wielka o nieustawionych cyfrach
+ */
+static BigCoeff *BigAlloc(size_t len) {
+    BigCoeff *big = malloc(sizeof(BigCoeff) + len * sizeof(uint64_t));
+    CHECK_PTR(big);
+    big->len = len;
+    big->negative = false;
+    return big;
+}
+
+/**
+ * Zamienia liczbę wielką na współczynnik, usuwając zerowe cyfry wiodące.
+ * Jeśli wartość mieści się w typie poly_coeff_t, zwalnia liczbę wielką
+ * i zwraca współczynnik będący liczbą.
+ * @param[in] big : liczba wielka, przejmowana na własność
+ * @return współczynnik
+ */
+static Poly BigToPoly(BigCoeff *big) {
+    while (big->len > 0 && big->digits[big->len - 1] == 0) {
+        big->len--;
+    }
+
+    if (big->len <= COEFF_DIGITS) {
+        unsigned __int128 magnitude = 0;
+        for (size_t i = big->len; i-- > 0;) {
+            magnitude = magnitude << 64 | big->digits[i];
+        }
+
+        if (magnitude <= COEFF_MAX_MAGNITUDE + big->negative) {
+            bool negative = big->negative;
+            free(big);
+            return PolyFromCoeff(
+                (poly_coeff_t) (negative ? -magnitude : magnitude));
+        }
+    }
+
+    return (Poly) {.size = 0, .arr = (Mono *) big};
+}
+
+/**
+ * Porównuje wartości bezwzględne dwóch liczb zapisanych cyframi bez zer
+ * wiodących.
+ * @param[in] a : cyfry liczby @f$a@f$
+ * @param[in] a_len : liczba cyfr @f$a@f$
+ * @param[in] b : cyfry liczby @f$b@f$
+ * @param[in] b_len : liczba cyfr @f$b@f$
+ * @return -1, 0 lub 1, gdy @f$|a|@f$ jest odpowiednio mniejsze, równe lub
+ * większe od @f$|b|@f$
+ */
+static int DigitsCompare(const uint64_t *a, size_t a_len, const uint64_t *b,
+                         size_t b_len) {
+    if (a_len != b_len) {
+        return a_len < b_len ? -1 : 1;
+    }
+
+    for (size_t i = a_len; i-- > 0;) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * Wylicza resztę z dzielenia wartości bezwzględnej liczby przez @p m.
+ * @param[in] digits : cyfry liczby
+ * @param[in] len : liczba cyfr
+ * @param[in] m : dzielnik
+ * @return reszta z przedziału @f$[0, m)@f$
+ */
+static uint64_t DigitsMod(const uint64_t *digits, size_t len, uint64_t m) {
+    uint64_t r = 0;
+
+    for (size_t i = len; i-- > 0;) {
+        r = (uint64_t) ((((unsigned __int128) r << 64) | digits[i]) % m);
+    }
+
+    return r;
+}
+
+/**
+ * Dzieli w miejscu wartość bezwzględną liczby przez @p m, usuwając zerowe
+ * cyfry wiodące ilorazu.
+ * @param[in,out] digits : cyfry liczby
+ * @param[in,out] len : liczba cyfr
+ * @param[in] m : dzielnik
+ * @return reszta z dzielenia
+ */
+static uint64_t DigitsDivide(uint64_t *digits, size_t *len, uint64_t m) {
+    uint64_t r = 0;
+
+    for (size_t i = *len; i-- > 0;) {
+        unsigned __int128 x = ((unsigned __int128) r << 64) | digits[i];
+        digits[i] = (uint64_t) (x / m);
+        r = (uint64_t) (x % m);
+    }
+
+    while (*len > 0 && digits[*len - 1] == 0) {
+        (*len)--;
+    }
+
+    return r;
+}
+
+/**
+ * Wylicza przybliżoną wartość bezwzględną współczynnika.
+ * @param[in] c : współczynnik
+ * @return @f$|c|@f$
+ */
+static double CoeffMagnitude(const Poly *c) {
+    CoeffDigits d;
+    CoeffGetDigits(c, &d);
+    double result = 0;
+
+    for (size_t i = d.len; i-- > 0;) {
+        result = result * 0x1p64 + (double) d.digits[i];
+    }
+
+    return result;
+}
+
+/**
+ * Wylicza resztę współczynnika modulo @p m.
+ * @param[in] c : współczynnik
+ * @param[in] m : moduł
+ * @return reszta z przedziału @f$[0, m)@f$
+ */
+static uint64_t CoeffResidue(const Poly *c, uint64_t m) {
+    CoeffDigits d;
+    CoeffGetDigits(c, &d);
+    uint64_t r = DigitsMod(d.digits, d.len, m);
+    return d.negative && r != 0 ? m - r : r;
+}
+
+/**
+ * Daje współczynnik przystający do @p c modulo ustawiony moduł, będący
+ * liczbą. Liczby wielkie są zamieniane na reszty.
+ * @param[in] c : współczynnik
+ * @return liczba przystająca do @p c
+ */
+static inline poly_coeff_t CoeffReduce(const Poly *c) {
+    return CoeffIsWord(c) ? c->coeff : (poly_coeff_t) CoeffResidue(c, modulus);
+}
+
+/**
+ * Daje współczynnik będący liczbą o tej samej reszcie co @p c modulo
+ * @f$2^{w}@f$, gdzie @f$w@f$ jest liczbą bitów typu poly_coeff_t.
+ * @param[in] c : współczynnik
+ * @return najmłodsze bity współczynnika
+ */
+static poly_coeff_t CoeffWrap(const Poly *c) {
+    CoeffDigits d;
+    CoeffGetDigits(c, &d);
+    unsigned __int128 low = 0;
+
+    for (size_t i = d.len < COEFF_DIGITS ? d.len : COEFF_DIGITS; i-- > 0;) {
+        low = low << 64 | d.digits[i];
+    }
+
+    return (poly_coeff_t) (d.negative ? -low : low);
+}
+
+/**
+ * Dodaje dokładnie dwa współczynniki, z których każdy może być liczbą
+ * wielką.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a + b@f$
+ */
+static Poly BigCoeffAdd(const Poly *a, const Poly *b) {
+    CoeffDigits x, y;
+    CoeffGetDigits(a, &x);
+    CoeffGetDigits(b, &y);
+
+    // przy różnych znakach od większej wartości bezwzględnej odejmujemy mniejszą
+    const CoeffDigits *u = &x;
+    const CoeffDigits *v = &y;
+    if (x.negative != y.negative &&
+        DigitsCompare(x.digits, x.len, y.digits, y.len) < 0) {
+        u = &y;
+        v = &x;
+    }
+
+    BigCoeff *sum = BigAlloc((u->len > v->len ? u->len : v->len) + 1);
+    sum->negative = u->negative;
+    uint64_t carry = 0;
+
+    for (size_t i = 0; i < sum->len; i++) {
+        unsigned __int128 d = i < u->len ? u->digits[i] : 0;
+        unsigned __int128 e = i < v->len ? v->digits[i] : 0;
+        unsigned __int128 t = u->negative == v->negative ? d + e + carry
+                                                         : d - e - carry;
+        sum->digits[i] = (uint64_t) t;
+        carry = (t >> 64) != 0;
+    }
+
+    return BigToPoly(sum);
+}
+
+/**
+ * Mnoży dokładnie dwa współczynniki, z których każdy może być liczbą wielką.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a \cdot b@f$
+ */
+static Poly BigCoeffMul(const Poly *a, const Poly *b) {
+    CoeffDigits x, y;
+    CoeffGetDigits(a, &x);
+    CoeffGetDigits(b, &y);
+
+    BigCoeff *product = BigAlloc(x.len + y.len);
+    product->negative = x.negative != y.negative;
+    memset(product->digits, 0, product->len * sizeof(uint64_t));
+
+    for (size_t i = 0; i < x.len; i++) {
+        uint64_t carry = 0;
+
+        for (size_t j = 0; j < y.len; j++) {
+            unsigned __int128 t = (unsigned __int128) x.digits[i] * y.digits[j] +
+                                  product->digits[i + j] + carry;
+            product->digits[i + j] = (uint64_t) t;
+            carry = (uint64_t) (t >> 64);
+        }
+        product->digits[i + y.len] = carry;
+    }
+
+    return BigToPoly(product);
+}
+
+/**
+ * Zmienia dokładnie znak współczynnika, który może być liczbą wielką.
+ * @param[in] a : współczynnik
+ * @return @f$-a@f$
+ */
+static Poly BigCoeffNeg(const Poly *a) {
+    CoeffDigits x;
+    CoeffGetDigits(a, &x);
+
+    BigCoeff *result = BigAlloc(x.len);
+    memcpy(result->digits, x.digits, x.len * sizeof(uint64_t));
+    result->negative = !x.negative;
+
+    return BigToPoly(result);
+}
+
+/**
+ * Dodaje dwa współczynniki będące liczbami. W trybie dokładnym
+ * przepełniona suma jest liczbą wielką; poza nim działa jak CoeffAdd.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a + b@f$
+ */
+static inline Poly CoeffSum(poly_coeff_t a, poly_coeff_t b) {
+    poly_coeff_t sum;
+
+    if (exact_coeffs && modulus == 0 && __builtin_add_overflow(a, b, &sum)) {
+        Poly x = PolyFromCoeff(a);
+        Poly y = PolyFromCoeff(b);
+        return BigCoeffAdd(&x, &y);
+    }
+
+    return PolyFromCoeff(CoeffAdd(a, b));
+}
+
+/**
+ * Mnoży dwa współczynniki będące liczbami. W trybie dokładnym
+ * przepełniony iloczyn jest liczbą wielką; poza nim działa jak CoeffMul.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a \cdot b@f$
+ */
+static inline Poly CoeffProduct(poly_coeff_t a, poly_coeff_t b) {
+    poly_coeff_t product;
+
+    if (exact_coeffs && modulus == 0 && __builtin_mul_overflow(a, b, &product)) {
+        Poly x = PolyFromCoeff(a);
+        Poly y = PolyFromCoeff(b);
+        return BigCoeffMul(&x, &y);
+    }
+
+    return PolyFromCoeff(CoeffMul(a, b));
+}
+
+/**
+ * Zmienia znak współczynnika będącego liczbą. W trybie dokładnym negacja
+ * najmniejszej wartości typu jest liczbą wielką; poza nim działa jak
+ * CoeffNeg.
+ * @param[in] a : współczynnik
+ * @return @f$-a@f$
+ */
+static inline Poly CoeffNegation(poly_coeff_t a) {
+    poly_coeff_t result;
+
+    if (exact_coeffs && modulus == 0 && __builtin_sub_overflow(0, a, &result)) {
+        Poly x = PolyFromCoeff(a);
+        return BigCoeffNeg(&x);
+    }
+
+    return PolyFromCoeff(CoeffNeg(a));
+}
+
+/**
+ * Dodaje dwa współczynniki, z których każdy może być liczbą wielką.
+ * Współczynniki będące liczbami dodawane są przez CoeffSum, a w trybie
+ * modularnym liczby wielkie najpierw zamieniane są na reszty.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a + b@f$
+ */
+static inline Poly CoeffAddPoly(const Poly *a, const Poly *b) {
+    if (CoeffIsWord(a) && CoeffIsWord(b)) {
+        return CoeffSum(a->coeff, b->coeff);
+    }
+    else if (modulus != 0) {
+        return PolyFromCoeff(CoeffAdd(CoeffReduce(a), CoeffReduce(b)));
+    }
+
+    return BigCoeffAdd(a, b);
+}
+
+/**
+ * Mnoży dwa współczynniki, z których każdy może być liczbą wielką, jak
+ * CoeffAddPoly.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a \cdot b@f$
+ */
+static inline Poly CoeffMulPoly(const Poly *a, const Poly *b) {
+    if (CoeffIsWord(a) && CoeffIsWord(b)) {
+        return CoeffProduct(a->coeff, b->coeff);
+    }
+    else if (modulus != 0) {
+        return PolyFromCoeff(CoeffMul(CoeffReduce(a), CoeffReduce(b)));
+    }
+
+    return BigCoeffMul(a, b);
+}
+
+/**
+ * Zmienia znak współczynnika, który może być liczbą wielką, jak
+ * CoeffAddPoly.
+ * @param[in] a : współczynnik
+ * @return @f$-a@f$
+ */
+static inline Poly CoeffNegPoly(const Poly *a) {
+    if (CoeffIsWord(a)) {
+        return CoeffNegation(a->coeff);
+    }
+    else if (modulus != 0) {
+        return PolyFromCoeff(CoeffNeg(CoeffReduce(a)));
+    }
+
+    return BigCoeffNeg(a);
+}
+
+/**
+ * Sprawdza równość dwóch współczynników. Liczba wielka nigdy nie jest równa
+ * współczynnikowi będącemu liczbą.
+ * @param[in] a : współczynnik
+ * @param[in] b : współczynnik
+ * @return @f$a = b@f$
+ */
+static bool CoeffIsEq(const Poly *a, const Poly *b) {
+    if (CoeffIsWord(a) || CoeffIsWord(b)) {
+        return CoeffIsWord(a) && CoeffIsWord(b) && a->coeff == b->coeff;
+    }
+
+    const BigCoeff *x = (const BigCoeff *) a->arr;
+    const BigCoeff *y = (const BigCoeff *) b->arr;
+    return x->negative == y->negative &&
+           DigitsCompare(x->digits, x->len, y->digits, y->len) == 0;
+}
+
+/**
+ * Robi kopię współczynnika, który może być liczbą wielką.
+ * @param[in] c : współczynnik
+ * @return kopia współczynnika
+ */
+static Poly CoeffClone(const Poly *c) {
+    if (CoeffIsWord(c)) {
+        return PolyFromCoeff(c->coeff);
+    }
+
+    const BigCoeff *big = (const BigCoeff *) c->arr;
+    BigCoeff *copy = BigAlloc(big->len);
+    copy->negative = big->negative;
+    memcpy(copy->digits, big->digits, big->len * sizeof(uint64_t));
+    return (Poly) {.size = 0, .arr = (Mono *) copy};
+}
+
+void PolySetExact(bool exact) {
+    exact_coeffs = exact;
+}
+
+bool PolyGetExact(void) {
+    return exact_coeffs;
+}
+
+Poly PolyCoeffFromString(const char *str, char **end) {
+    bool negative = str[0] == '-';
+    const char *digits = negative ? str + 1 : str;
+    size_t count = 0;
+
+    while (digits[count] >= '0' && digits[count] <= '9') {
+        count++;
+    }
+
+    if (end != NULL) {
+        *end = (char *) (count == 0 ? str : digits + count);
+    }
+
+    BigCoeff *big = BigAlloc(count / DECIMAL_CHUNK_DIGITS + 1);
+    big->len = 0;
+    big->negative = negative;
+
+    // liczba = liczba * 10^k + kolejne k cyfr dziesiętnych
+    for (size_t i = 0; i < count;) {
+        uint64_t scale = 1;
+        uint64_t carry = 0;
+
+        for (size_t k = 0; k < DECIMAL_CHUNK_DIGITS && i < count; k++, i++) {
+            scale *= 10;
+            carry = carry * 10 + (uint64_t) (digits[i] - '0');
+        }
+
+        for (size_t j = 0; j < big->len; j++) {
+            unsigned __int128 t = (unsigned __int128) big->digits[j] * scale +
+                                  carry;
+            big->digits[j] = (uint64_t) t;
+            carry = (uint64_t) (t >> 64);
+        }
+
+        if (carry != 0) {
+            big->digits[big->len++] = carry;
+        }
+    }
+
+    return BigToPoly(big);
+}
+
+char *PolyCoeffToString(const Poly *p) {
+    CoeffDigits d;
+    CoeffGetDigits(p, &d);
+
+    size_t len = d.len;
+    uint64_t *work = malloc((len + 1) * sizeof(uint64_t));
+    CHECK_PTR(work);
+    memcpy(work, d.digits, len * sizeof(uint64_t));
+
+    // cyfra o podstawie 2^64 to mniej niż 20 cyfr dziesiętnych
+    size_t size = 20 * len + 3;
+    char *str = malloc(size);
+    CHECK_PTR(str);
+    size_t pos = size - 1;
+    str[pos] = '\0';
+
+    do {
+        uint64_t chunk = DigitsDivide(work, &len, DECIMAL_CHUNK);
+
+        for (size_t k = 0; k < DECIMAL_CHUNK_DIGITS && (len > 0 || chunk > 0);
+             k++) {
+            str[--pos] = (char) ('0' + chunk % 10);
+            chunk /= 10;
+        }
+    } while (len > 0);
+
+    if (pos == size - 1) {
+        str[--pos] = '0';
+    }
+    if (d.negative) {
+        str[--pos] = '-';
+    }
+
+    memmove(str, &str[pos], size - pos);
+    free(work);
+    return str;
+}
+
+/**
+ * Mnoży dwie reszty modulo @p m.
+ * @param[in] a : reszta z przedziału @f$[0, m)@f$
+ * @param[in] b : reszta z przedziału @f$[0, m)@f$
+ * @param[in] m : moduł
+ * @return @f$a \cdot b \bmod m@f$
+ */
+static uint64_t MulMod(uint64_t a, uint64_t b, uint64_t m) {
+    return (uint64_t) ((unsigned __int128) a * b % m);
+}
+
+/**
+ * Podnosi resztę do potęgi modulo @p m.
+ * @param[in] a : reszta z przedziału @f$[0, m)@f$
+ * @param[in] e : wykładnik
+ * @param[in] m : moduł
+ * @return @f$a^e \bmod m@f$
+ */
+static uint64_t PowMod(uint64_t a, uint64_t e, uint64_t m) {
+    uint64_t result = 1;
+
+    for (; e > 0; e /= 2) {
+        if (e % 2 == 1) {
+            result = MulMod(result, a, m);
+        }
+        a = MulMod(a, a, m);
+    }
+
+    return result;
+}
+
+bool PolyIsPrime(poly_coeff_t n) {
+    static const uint64_t bases[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+
+    if (n < 2 || n >= POLY_MAX_MODULUS) {
+        return false;
+    }
+
+    uint64_t m = (uint64_t) n;
+    uint64_t d = m - 1;
+    unsigned s = 0;
+
+    while (d % 2 == 0) {
+        d /= 2;
+        s++;
+    }
+
+    for (size_t i = 0; i < sizeof(bases) / sizeof(bases[0]); i++) {
+        if (m == bases[i]) {
+            return true;
+        }
+        else if (m % bases[i] == 0) {
+            return false;
+        }
+
+        uint64_t x = PowMod(bases[i], d, m);
+        bool witness = x != 1 && x != m - 1;
+        for (unsigned r = 1; r < s && witness; r++) {
+            x = MulMod(x, x, m);
+            witness = x != m - 1;
+        }
+
+        if (witness) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void PolySetModulus(poly_coeff_t m) {
+    assert(m == 0 || PolyIsPrime(m));
+    modulus = (uint64_t) m;
+    modulus_bits = 0;
+    barrett_mu = 0;
+
+    if (m != 0) {
+        while ((modulus >> modulus_bits) != 0) {
+            modulus_bits++;
+        }
+        barrett_mu = (uint64_t) (((unsigned __int128) 1 << (2 * modulus_bits))
+                                 / modulus);
+    }
+}
+
+poly_coeff_t PolyGetModulus(void) {
+    return (poly_coeff_t) modulus;
+}
+
+bool PolyCoeffOverflow(void) {
+    bool result = coeff_overflow;
+    coeff_overflow = false;
+    return result;
+}
 
 void PolyDestroy(Poly *p) {
+    // liczba wielka ma zero jednomianów, więc zwalniana jest tylko jej tablica
     if (p->arr != NULL) {
         for (size_t i = 0; i < p->size; i++) {
-            MonoDestroy(&p->arr[i]);
+            MonoDestroy(&p->arr[i]);
+        }
+        free(p->arr);
+    }
+ }
+
+Poly PolyClone(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return CoeffClone(p);
+    }
+
+    Poly q = (Poly) {.size = p->size, .arr = malloc(p->size * sizeof(Mono))};
+    CHECK_PTR(q.arr);
+
+    for (size_t i = 0; i < q.size; i++) {
+        q.arr[i] = MonoClone(&p->arr[i]);
+    }
+
+    return q;
+}
+
+/**
+ * Porównuje wykładniki dwóch jednomianów.
+ * @param[in] a : wskaźnik na jednomian
+ * @param[in] b : wskaźnik na jednomian
+ * @return Jeśli wykładnik @p a jest mniejszy zwraca -1, jeśli równy 0,
+ * a jeśli większy 1.
+ */
+static int ExpComparator(const void *a, const void *b) {
+    poly_exp_t x = MonoGetExp((const Mono *) a);
+    poly_exp_t y = MonoGetExp((const Mono *) b);
+
+    return (x > y) - (x < y);
+}
+
+/**
+ * Zwraca klucz sortowania pozycyjnego jednomianu: wykładnik jako liczbę
+ * bez znaku o tym samym porządku.
+ * @param[in] m : jednomian
+ * @return klucz
+ */
+static inline uint32_t MonoExpKey(const Mono *m) {
+    return (uint32_t) MonoGetExp(m) ^ UINT32_C(0x80000000);
+}
+
+/**
+ * Sortuje stabilnie listę jednomianów pozycyjnie (LSD) po bajtach
+ * wykładników. Przebiegi, w których wszystkie klucze mają ten sam bajt,
+ * są pomijane, więc małe wykładniki sortowane są w jednym przebiegu.
+ * @param[in] monos : tablica jednomianów
+ * @param[in] count : liczba jednomianów
+ */
+static void RadixSortMonos(Mono monos[], size_t count) {
+    Mono *buffer = malloc(count * sizeof(Mono));
+    CHECK_PTR(buffer);
+    Mono *from = monos;
+    Mono *to = buffer;
+
+    for (unsigned shift = 0; shift < 32; shift += 8) {
+        size_t pos[256] = {0};
+        for (size_t i = 0; i < count; i++) {
+            pos[(MonoExpKey(&from[i]) >> shift) & 0xFF]++;
+        }
+
+        if (pos[(MonoExpKey(&from[0]) >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        size_t sum = 0;
+        for (size_t b = 0; b < 256; b++) {
+            size_t c = pos[b];
+            pos[b] = sum;
+            sum += c;
+        }
+
+        for (size_t i = 0; i < count; i++) {
+            to[pos[(MonoExpKey(&from[i]) >> shift) & 0xFF]++] = from[i];
+        }
+
+        Mono *tmp = from;
+        from = to;
+        to = tmp;
+    }
+
+    if (from != monos) {
+        memcpy(monos, from, count * sizeof(Mono));
+    }
+    free(buffer);
+}
+
+/**
+ * Sortuje listę jednomianów. Krótkie listy sortowane są przez qsort,
+ * długie pozycyjnie.
+ * @param[in] monos : tablica jednomianów
+ * @param[in] count : liczba jednomianów
+ */
+static void SortMonos(Mono monos[], size_t count) {
+    if (count < RADIX_SORT_MIN) {
+        qsort(monos, count, sizeof(Mono), ExpComparator);
+    }
+    else {
+        RadixSortMonos(monos, count);
+    }
+}
+
+bool PolyIsDeepCoeff(Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return true;
+    }
+    else if (p->size == 1 && p->arr[0].exp == 0) {
+        return PolyIsDeepCoeff(&p->arr[0].p);
+    }
+    else {
+        return false;
+    }
+}
+
+poly_coeff_t PolyGetDeepCoeff(Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return CoeffWrap(p);
+    }
+    else {
+        return PolyGetDeepCoeff(&p->arr[0].p);
+    }
+}
+
+/**
+ * Sprawdza, czy wielomian jest liściem, czyli niepustą listą jednomianów,
+ * których współczynniki są liczbami. Na tym poziomie operacje nie muszą
+ * schodzić w rekurencję i mogą działać bezpośrednio na współczynnikach.
+ * Liczby wielkie nie są liczbami w tym sensie, więc wielomiany z nimi
+ * przechodzą ścieżką ogólną.
+ * @param[in] p : wielomian
+ * @return Czy wielomian jest liściem?
+ */
+static bool PolyIsLeaf(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < p->size; i++) {
+        if (!CoeffIsWord(&p->arr[i].p)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Sprawdza, czy wielomian jest jednomianem @f$c x_0^{a} x_1^{b} \cdots@f$,
+ * czyli czy na każdym poziomie ma tylko jeden jednomian. Współczynnik też
+ * jest jednomianem. Sprawdzenie kosztuje tyle, ile głębokość wielomianu.
+ * @param[in] p : wielomian
+ * @return Czy wielomian jest jednomianem?
+ */
+static bool PolyIsMonomial(const Poly *p) {
+    while (!PolyIsCoeff(p)) {
+        if (p->size != 1) {
+            return false;
+        }
+        p = &p->arr[0].p;
+    }
+
+    return true;
+}
+
+/** Bit rodzaju wielomianu: wielomian jest liściem (zob. PolyIsLeaf). */
+#define POLY_LEAF 1u
+
+/** Bit rodzaju wielomianu: wielomian jest jednomianem (PolyIsMonomial). */
+#define POLY_MONOMIAL 2u
+
+/**
+ * Wylicza rodzaj wielomianu, czyli zbiór bitów POLY_*. Mnożenie i
+ * potęgowanie wyliczają rodzaj każdego czynnika raz i przekazują go do
+ * funkcji pomocniczych, zamiast przeglądać ten sam węzeł przy każdym
+ * iloczynie i każdym kroku rekurencji.
+ * @param[in] p : wielomian
+ * @return rodzaj wielomianu
+ */
+static unsigned PolyKind(const Poly *p) {
+    unsigned kind = PolyIsMonomial(p) ? POLY_MONOMIAL : 0;
+
+    if (PolyIsLeaf(p)) {
+        kind |= POLY_LEAF;
+    }
+
+    return kind;
+}
+
+/**
+ * Normalizuje wielomian zbudowany z tablicy jednomianów. Jeśli jest on postaci
+ * @f$(c, 0)@f$, gdzie @f$c@f$ jest liczbą, zamienia go na współczynnik @f$c@f$.
+ * Wszystkie funkcje budujące wielomiany przepuszczają wynik przez tę funkcję,
+ * więc w wielomianach nie powstają łańcuchy zagłębionych współczynników.
+ * @param[in] p : wielomian, przejmowany na własność
+ * @return znormalizowany wielomian
+ */
+static Poly PolyNormalize(Poly p) {
+    if (!PolyIsCoeff(&p) && p.size == 1 && MonoGetExp(&p.arr[0]) == 0 &&
+        PolyIsCoeff(&p.arr[0].p)) {
+        Poly coeff = p.arr[0].p;
+        free(p.arr);
+        return coeff;
+    }
+
+    return p;
+}
+
+/**
+ * Kopiuje jednomian pod wskazany adres. Jednomian, którego współczynnik
+ * jest liczbą, kopiowany jest bezpośrednio, bez wywołania PolyClone.
+ * @param[out] dst : miejsce na kopię
+ * @param[in] m : jednomian
+ */
+static inline void MonoCopy(Mono *dst, const Mono *m) {
+    if (CoeffIsWord(&m->p)) {
+        *dst = *m;
+    }
+    else {
+        *dst = MonoClone(m);
+    }
+}
+
+Poly PolyAdd(const Poly *p, const Poly *q) {
+    if (PolyIsZero(p)) {
+        Poly r = PolyClone(q);
+        return r;
+    }
+    else if (PolyIsZero(q)) {
+        Poly r = PolyClone(p);
+        return r;
+    }
+    else if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
+        return CoeffAddPoly(p, q);
+    }
+    else if (PolyIsCoeff(p)) { // jednomian (p, 0) na stosie, bez alokacji
+        Mono m = (Mono) {.p = *p, .exp = 0};
+        Poly r = (Poly) {.size = 1, .arr = &m};
+        return PolyAdd(&r, q);
+    }
+    else if (PolyIsCoeff(q)) { // jak wyżej
+        Mono m = (Mono) {.p = *q, .exp = 0};
+        Poly r = (Poly) {.size = 1, .arr = &m};
+        return PolyAdd(p, &r);
+    }
+    else {
+        Poly r = (Poly) {.size = 0,
+                         .arr = malloc((p->size + q->size) * sizeof(Mono))};
+        CHECK_PTR(r.arr);
+        size_t index_p = 0, index_q = 0;
+
+        while (index_p < p->size && index_q < q->size) {
+            poly_exp_t exp_p = MonoGetExp(&p->arr[index_p]);
+            poly_exp_t exp_q = MonoGetExp(&q->arr[index_q]);
+
+            if (exp_p < exp_q) {
+                MonoCopy(&r.arr[r.size++], &p->arr[index_p++]);
+            }
+            else if (exp_p > exp_q) {
+                MonoCopy(&r.arr[r.size++], &q->arr[index_q++]);
+            }
+            else {
+                const Poly *a = &p->arr[index_p++].p;
+                const Poly *b = &q->arr[index_q++].p;
+                // współczynniki liścia sumowane są bez rekurencji
+                Poly sum = CoeffIsWord(a) && CoeffIsWord(b)
+                           ? CoeffSum(a->coeff, b->coeff) : PolyAdd(a, b);
+                if (!PolyIsZero(&sum)) {
+                    r.arr[r.size++] = (Mono) {.p = sum, .exp = exp_p};
+                }
+            }
+        }
+        while (index_p < p->size) {
+            MonoCopy(&r.arr[r.size++], &p->arr[index_p++]);
+        }
+        while (index_q < q->size) {
+            MonoCopy(&r.arr[r.size++], &q->arr[index_q++]);
+        }
+
+        if (r.size == 0) {
+            free(r.arr);
+            return PolyZero();
+        }
+
+        r.arr = realloc(r.arr, r.size * sizeof(Mono));
+        CHECK_PTR(r.arr);
+        return PolyNormalize(r);
+    }
+}
+
+/**
+ * Sumuje wielomiany z jednomianów @p monos o tym samym wykładniku, przejmując
+ * je na własność. Jednomiany wszystkich składników są scalane jednym
+ * wywołaniem PolyOwnMonos zamiast kolejnych wywołań PolyAdd. Współczynnik
+ * @f$c@f$ jest przy tym jednomianem @f$c x^0@f$ kolejnej zmiennej.
+ * @param[in] monos : jednomiany o równych wykładnikach
+ * @param[in] count : liczba jednomianów
+ * @return suma wielomianów z jednomianów
+ */
+static Poly PolySumOwned(Mono monos[], size_t count) {
+    size_t total = 0;
+    bool all_coeffs = true;
+
+    for (size_t i = 0; i < count; i++) {
+        if (PolyIsCoeff(&monos[i].p)) {
+            total++;
+        }
+        else {
+            total += monos[i].p.size;
+            all_coeffs = false;
+        }
+    }
+
+    if (all_coeffs) {
+        Poly sum = PolyZero();
+        for (size_t i = 0; i < count; i++) {
+            Poly next = CoeffAddPoly(&sum, &monos[i].p);
+            PolyDestroy(&sum);
+            PolyDestroy(&monos[i].p);
+            sum = next;
+        }
+        return sum;
+    }
+
+    Mono *sub = malloc(total * sizeof(Mono));
+    CHECK_PTR(sub);
+    size_t size = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        if (PolyIsZero(&monos[i].p)) {
+            continue;
+        }
+        else if (PolyIsCoeff(&monos[i].p)) {
+            sub[size++] = (Mono) {.p = monos[i].p, .exp = 0};
+        }
+        else {
+            memcpy(&sub[size], monos[i].p.arr, monos[i].p.size * sizeof(Mono));
+            size += monos[i].p.size;
+            free(monos[i].p.arr);
+        }
+    }
+
+    return PolyOwnMonos(size, sub);
+}
+
+Poly PolyOwnMonos(size_t count, Mono *monos) {
+    if (count == 0 || monos == NULL) {
+        free(monos);
+        return PolyZero();
+    }
+    else if (count == 1) {
+        if (PolyIsZero(&monos[0].p)) {
+            free(monos);
+            return PolyZero();
+        }
+
+        return PolyNormalize((Poly) {.size = 1, .arr = monos});
+    }
+
+    for (size_t i = 1; i < count; i++) {
+        if (MonoGetExp(&monos[i - 1]) > MonoGetExp(&monos[i])) {
+            SortMonos(monos, count);
+            break;
+        }
+    }
+
+    // wynik jest zapisywany w miejscu, na początku tablicy monos
+    Poly result = {.size = 0, .arr = monos};
+    size_t i = 0;
+
+    while (i < count) {
+        size_t j = i + 1;
+        while (j < count && MonoGetExp(&monos[j]) == MonoGetExp(&monos[i])) {
+            j++;
+        }
+
+        poly_exp_t exp = MonoGetExp(&monos[i]);
+        Poly sum = j - i == 1 ? monos[i].p : PolySumOwned(&monos[i], j - i);
+
+        if (!PolyIsZero(&sum)) {
+            result.arr[result.size++] = (Mono) {.p = sum, .exp = exp};
+        }
+        i = j;
+    }
+
+    if (result.size == 0) {
+        free(monos);
+        return PolyZero();
+    }
+    else if (result.size < count) {
+        result.arr = realloc(result.arr, result.size * sizeof(Mono));
+        CHECK_PTR(result.arr);
+    }
+
+    return PolyNormalize(result);
+}
+
+Poly PolyAddMonos(size_t count, const Mono monos[]) {
+    if (count == 0 || monos == NULL) {
+        return PolyZero();
+    }
+
+    Mono *copy = malloc(count * sizeof(Mono));
+    CHECK_PTR(copy);
+    for (size_t i = 0; i < count; i++) {
+        copy[i] = monos[i];
+    }
+
+    return PolyOwnMonos(count, copy);
+}
+
+Poly PolyCloneMonos(size_t count, const Mono monos[]) {
+    if (count == 0 || monos == NULL) {
+        return PolyZero();
+    }
+
+    Mono *copy = malloc(count * sizeof(Mono));
+    CHECK_PTR(copy);
+    for (size_t i = 0; i < count; i++) {
+        copy[i] = MonoClone(&monos[i]);
+    }
+
+    return PolyOwnMonos(count, copy);
+}
+
+PolyBuilder PolyBuilderInit(size_t capacity) {
+    PolyBuilder b = {.arr = NULL, .size = 0, .capacity = capacity,
+                     .sorted = true};
+
+    if (capacity > 0) {
+        b.arr = malloc(capacity * sizeof(Mono));
+        CHECK_PTR(b.arr);
+    }
+
+    return b;
+}
+
+void PolyBuilderAdd(PolyBuilder *b, Mono *m) {
+    if (PolyIsZero(&m->p)) {
+        PolyDestroy(&m->p);
+        return;
+    }
+
+    if (b->size > 0) {
+        Mono *last = &b->arr[b->size - 1];
+
+        if (b->sorted && MonoGetExp(last) == MonoGetExp(m)) {
+            if (CoeffIsWord(&last->p) && CoeffIsWord(&m->p)) {
+                last->p = CoeffSum(last->p.coeff, m->p.coeff);
+            }
+            else {
+                Poly sum = PolyAdd(&last->p, &m->p);
+                PolyDestroy(&last->p);
+                PolyDestroy(&m->p);
+                last->p = sum;
+            }
+
+            if (PolyIsZero(&last->p)) {
+                b->size--;
+            }
+            return;
+        }
+        else if (MonoGetExp(last) > MonoGetExp(m)) {
+            b->sorted = false;
+        }
+    }
+
+    if (b->size == b->capacity) {
+        b->capacity = b->capacity == 0 ? 4 : 2 * b->capacity;
+        b->arr = realloc(b->arr, b->capacity * sizeof(Mono));
+        CHECK_PTR(b->arr);
+    }
+
+    b->arr[b->size++] = *m;
+}
+
+Poly PolyBuilderFinish(PolyBuilder *b) {
+    Poly result;
+
+    if (!b->sorted) {
+        result = PolyOwnMonos(b->size, b->arr);
+    }
+    else if (b->size == 0) {
+        free(b->arr);
+        result = PolyZero();
+    }
+    else {
+        if (b->size < b->capacity) {
+            b->arr = realloc(b->arr, b->size * sizeof(Mono));
+            CHECK_PTR(b->arr);
+        }
+        result = PolyNormalize((Poly) {.size = b->size, .arr = b->arr});
+    }
+
+    *b = PolyBuilderInit(0);
+    return result;
+}
+
+/**
+ * Mnoży wielomian przez stałą.
+ * @param[in] p : wielomian
+ * @param[in] coeff : stała, być może liczba wielka
+ * @return @f$p * coeff@f$
+ */
+static Poly PolyMulByCoeff(const Poly *p, const Poly *coeff) {
+    if (PolyIsCoeff(p)) {
+        return CoeffMulPoly(p, coeff);
+    }
+    else {
+        Poly q = (Poly) {.size = 0, .arr = malloc(p->size * sizeof(Mono))};
+        CHECK_PTR(q.arr);
+
+        for (size_t i = 0; i < p->size; i++) {
+            Poly pom = PolyMulByCoeff(&p->arr[i].p, coeff);
+
+            if (!PolyIsZero(&pom)) {
+                q.arr[q.size].p = pom;
+                q.arr[q.size].exp = MonoGetExp(&p->arr[i]);
+                q.size++;
+            }
+        }
+
+        if (q.size == 0) {
+            free(q.arr);
+            return PolyZero();
+        }
+        else {
+            q.arr = realloc(q.arr, q.size * sizeof(Mono));
+            CHECK_PTR(q.arr);
+            return PolyNormalize(q);
+        }
+    }
+}
+
+/**
+ * Mnoży dwa liście. Iloczyny jednomianów liczone są bezpośrednio na
+ * współczynnikach, bez rekurencyjnych wywołań PolyMul.
+ * @param[in] p : liść @f$p@f$
+ * @param[in] q : liść @f$q@f$
+ * @return @f$p * q@f$
+ */
+static Poly PolyMulLeaves(const Poly *p, const Poly *q) {
+    PolyBuilder b = PolyBuilderInit(p->size * q->size);
+
+    for (size_t i = 0; i < p->size; i++) {
+        for (size_t j = 0; j < q->size; j++) {
+            Mono m = {
+                .p = CoeffProduct(p->arr[i].p.coeff, q->arr[j].p.coeff),
+                .exp = MonoGetExp(&p->arr[i]) + MonoGetExp(&q->arr[j])};
+            PolyBuilderAdd(&b, &m);
+        }
+    }
+
+    return PolyBuilderFinish(&b);
+}
+
+/**
+ * Mnoży wielomian przez jednomian. Na każdym poziomie wykładniki jednomianów
+ * @p p są tylko przesuwane o wykładnik jednomianu @p m, więc ich kolejność
+ * się nie zmienia i wynik nie wymaga sortowania ani scalania.
+ * @param[in] p : wielomian niebędący współczynnikiem
+ * @param[in] m : jednomian niebędący współczynnikiem
+ * @return @f$p \cdot m@f$
+ */
+static Poly PolyMulByMonomial(const Poly *p, const Poly *m) {
+    const Poly *inner = &m->arr[0].p;
+    poly_exp_t shift = MonoGetExp(&m->arr[0]);
+    Poly r = {.size = 0, .arr = malloc(p->size * sizeof(Mono))};
+    CHECK_PTR(r.arr);
+
+    for (size_t i = 0; i < p->size; i++) {
+        const Poly *child = &p->arr[i].p;
+        Poly product;
+
+        if (PolyIsCoeff(inner)) {
+            product = PolyMulByCoeff(child, inner);
+        }
+        else if (PolyIsCoeff(child)) {
+            product = PolyMulByCoeff(inner, child);
+        }
+        else {
+            product = PolyMulByMonomial(child, inner);
+        }
+
+        if (!PolyIsZero(&product)) {
+            r.arr[r.size].p = product;
+            r.arr[r.size].exp = MonoGetExp(&p->arr[i]) + shift;
+            r.size++;
+        }
+    }
+
+    if (r.size == 0) {
+        free(r.arr);
+        return PolyZero();
+    }
+    else if (r.size < p->size) {
+        r.arr = realloc(r.arr, r.size * sizeof(Mono));
+        CHECK_PTR(r.arr);
+    }
+
+    return PolyNormalize(r);
+}
+
+PolyAccumulator PolyAccumulatorInit(void) {
+    PolyAccumulator acc;
+
+    for (size_t i = 0; i < POLY_ACC_LEVELS; i++) {
+        acc.buckets[i] = PolyZero();
+    }
+
+    return acc;
+}
+
+/**
+ * Wyznacza najniższy kubełek akumulatora, w którym mieści się wielomian:
+ * kubełek @f$i@f$ mieści wielomiany o co najwyżej @f$4^i@f$ jednomianach.
+ * @param[in] p : wielomian
+ * @return indeks kubełka
+ */
+static size_t AccumulatorLevel(const Poly *p) {
+    size_t size = PolyIsCoeff(p) ? 1 : p->size;
+    size_t level = 0;
+
+    for (size_t capacity = 1; capacity < size && level + 1 < POLY_ACC_LEVELS;
+         capacity *= 4) {
+        level++;
+    }
+
+    return level;
+}
+
+void PolyAccumulatorAddOwned(PolyAccumulator *acc, Poly *p) {
+    Poly sum = *p;
+    size_t level = AccumulatorLevel(&sum);
+    *p = PolyZero();
+
+    while (!PolyIsZero(&sum)) {
+        if (PolyIsZero(&acc->buckets[level])) {
+            acc->buckets[level] = sum;
+            return;
+        }
+
+        Poly merged = PolyAdd(&acc->buckets[level], &sum);
+        PolyDestroy(&acc->buckets[level]);
+        PolyDestroy(&sum);
+        acc->buckets[level] = PolyZero();
+        sum = merged;
+
+        size_t merged_level = AccumulatorLevel(&sum);
+        if (merged_level > level) {
+            level = merged_level;
+        }
+    }
+}
+
+void PolyAccumulatorAdd(PolyAccumulator *acc, const Poly *p) {
+    Poly copy = PolyClone(p);
+    PolyAccumulatorAddOwned(acc, &copy);
+}
+
+void PolyAccumulatorAddScaledMono(PolyAccumulator *acc, const Poly *p,
+                                  poly_coeff_t coeff, poly_exp_t exp) {
+    if (coeff == 0 || PolyIsZero(p)) {
+        return;
+    }
+
+    Poly term;
+    Poly c = PolyFromCoeff(coeff);
+    if (exp == 0) {
+        term = PolyMulByCoeff(p, &c);
+    }
+    else { // jednomian (coeff, exp) na stosie, bez alokacji
+        Mono m = {.p = c, .exp = exp};
+        Poly power = {.size = 1, .arr = &m};
+        term = PolyIsCoeff(p) ? PolyMulByCoeff(&power, p)
+                              : PolyMulByMonomial(p, &power);
+    }
+
+    PolyAccumulatorAddOwned(acc, &term);
+}
+
+Poly PolyAccumulatorFinish(PolyAccumulator *acc) {
+    Poly result = PolyZero();
+
+    for (size_t i = 0; i < POLY_ACC_LEVELS; i++) {
+        if (PolyIsZero(&acc->buckets[i])) {
+            continue;
+        }
+        else if (PolyIsZero(&result)) {
+            result = acc->buckets[i];
+        }
+        else {
+            Poly sum = PolyAdd(&result, &acc->buckets[i]);
+            PolyDestroy(&result);
+            PolyDestroy(&acc->buckets[i]);
+            result = sum;
+        }
+        acc->buckets[i] = PolyZero();
+    }
+
+    return result;
+}
+
+/**
+ * Wylicza rodzaje dzieci wielomianu, każde raz na iloczyn.
+ * @param[in] p : wielomian niebędący współczynnikiem
+ * @return tablica rodzajów, do zwolnienia przez wywołującego
+ */
+static unsigned *PolyChildKinds(const Poly *p) {
+    unsigned *kinds = malloc(p->size * sizeof(unsigned));
+    CHECK_PTR(kinds);
+
+    for (size_t i = 0; i < p->size; i++) {
+        kinds[i] = PolyKind(&p->arr[i].p);
+    }
+
+    return kinds;
+}
+
+static Poly PolyMulKinds(const Poly *p, unsigned p_kind, const Poly *q,
+                         unsigned q_kind);
+
+/**
+ * Dodaje do akumulatora iloczyn @f$p \cdot q@f$. W ogólnym przypadku
+ * iloczyn nie jest budowany w całości: kolejne wiersze
+ * @f$p_i x_0^{e_i} \cdot q@f$ mają rosnące wykładniki, więc każdy jest
+ * budowany bez sortowania i od razu trafia do akumulatora.
+ * @param[in,out] acc : akumulator
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] p_kind : rodzaj wielomianu @p p
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] q_kind : rodzaj wielomianu @p q
+ */
+static void PolyAccumulateProduct(PolyAccumulator *acc, const Poly *p,
+                                  unsigned p_kind, const Poly *q,
+                                  unsigned q_kind) {
+    if (((p_kind | q_kind) & POLY_MONOMIAL) ||
+        (p_kind & q_kind & POLY_LEAF)) {
+        Poly product = PolyMulKinds(p, p_kind, q, q_kind);
+        PolyAccumulatorAddOwned(acc, &product);
+        return;
+    }
+
+    unsigned *q_kinds = PolyChildKinds(q);
+
+    for (size_t i = 0; i < p->size; i++) {
+        unsigned kind = PolyKind(&p->arr[i].p);
+        PolyBuilder b = PolyBuilderInit(q->size);
+        for (size_t j = 0; j < q->size; j++) {
+            Mono m = {.p = PolyMulKinds(&p->arr[i].p, kind, &q->arr[j].p,
+                                        q_kinds[j]),
+                      .exp = MonoGetExp(&p->arr[i]) + MonoGetExp(&q->arr[j])};
+            PolyBuilderAdd(&b, &m);
+        }
+
+        Poly row = PolyBuilderFinish(&b);
+        PolyAccumulatorAddOwned(acc, &row);
+    }
+
+    free(q_kinds);
+}
+
+/**
+ * Mnoży dwa wielomiany o wyliczonych już rodzajach.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] p_kind : rodzaj wielomianu @p p
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] q_kind : rodzaj wielomianu @p q
+ * @return @f$p \cdot q@f$
+ */
+static Poly PolyMulKinds(const Poly *p, unsigned p_kind, const Poly *q,
+                         unsigned q_kind) {
+    if (PolyIsZero(p) || PolyIsZero(q)) {
+        return PolyZero();
+    }
+    else if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
+        return CoeffMulPoly(p, q);
+    }
+    else if (PolyIsCoeff(p)) {
+        return PolyMulByCoeff(q, p);
+    }
+    else if (PolyIsCoeff(q)) {
+        return PolyMulByCoeff(p, q);
+    }
+    else if (q_kind & POLY_MONOMIAL) {
+        return PolyMulByMonomial(p, q);
+    }
+    else if (p_kind & POLY_MONOMIAL) {
+        return PolyMulByMonomial(q, p);
+    }
+    else if (p_kind & q_kind & POLY_LEAF) {
+        return PolyMulLeaves(p, q);
+    }
+    else {
+        PolyAccumulator acc = PolyAccumulatorInit();
+        PolyAccumulateProduct(&acc, p, p_kind, q, q_kind);
+        return PolyAccumulatorFinish(&acc);
+    }
+}
+
+Poly PolyMul(const Poly *p, const Poly *q) {
+    return PolyMulKinds(p, PolyKind(p), q, PolyKind(q));
+}
+
+Poly PolyFma(const Poly *p, const Poly *q, const Poly *r) {
+    PolyAccumulator acc = PolyAccumulatorInit();
+    PolyAccumulateProduct(&acc, p, PolyKind(p), q, PolyKind(q));
+    PolyAccumulatorAdd(&acc, r);
+    return PolyAccumulatorFinish(&acc);
+}
+
+void PolyFmaAssign(Poly *r, const Poly *p, const Poly *q) {
+    PolyAccumulator acc = PolyAccumulatorInit();
+    // iloczyn najpierw, bo r może być jednym z czynników
+    PolyAccumulateProduct(&acc, p, PolyKind(p), q, PolyKind(q));
+    PolyAccumulatorAddOwned(&acc, r);
+    *r = PolyAccumulatorFinish(&acc);
+}
+
+/**
+ * Wylicza najmniejszy stopień łączny jednomianu wielomianu. Dla
+ * współczynnika (także zerowego) jest to 0.
+ * @param[in] p : wielomian
+ * @return najmniejszy stopień łączny
+ */
+static poly_exp_t PolyLowDeg(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return 0;
+    }
+
+    poly_exp_t low = MonoGetExp(&p->arr[0]) + PolyLowDeg(&p->arr[0].p);
+
+    // wykładniki rosną, więc od wykładnika low nic mniejszego nie będzie
+    for (size_t i = 1; i < p->size && MonoGetExp(&p->arr[i]) < low; i++) {
+        poly_exp_t deg = MonoGetExp(&p->arr[i]) + PolyLowDeg(&p->arr[i].p);
+        if (deg < low) {
+            low = deg;
+        }
+    }
+
+    return low;
+}
+
+/**
+ * Odcina jednomiany o stopniu łącznym większym niż @p deg.
+ * @param[in] p : wielomian
+ * @param[in] deg : największy zachowany stopień łączny
+ * @return @p p bez jednomianów stopnia większego niż @p deg
+ */
+static Poly PolyTruncate(const Poly *p, poly_exp_t deg) {
+    if (deg < 0) {
+        return PolyZero();
+    }
+    else if (PolyIsCoeff(p)) {
+        return CoeffClone(p);
+    }
+
+    PolyBuilder b = PolyBuilderInit(0);
+
+    for (size_t i = 0; i < p->size && MonoGetExp(&p->arr[i]) <= deg; i++) {
+        Mono m = {.p = PolyTruncate(&p->arr[i].p, deg - MonoGetExp(&p->arr[i])),
+                  .exp = MonoGetExp(&p->arr[i])};
+        PolyBuilderAdd(&b, &m);
+    }
+
+    return PolyBuilderFinish(&b);
+}
+
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t deg) {
+    if (deg < 0 || PolyIsZero(p) || PolyIsZero(q)) {
+        return PolyZero();
+    }
+    else if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
+        return CoeffMulPoly(p, q);
+    }
+    else if (PolyIsCoeff(p) || PolyIsCoeff(q)) {
+        Poly truncated = PolyTruncate(PolyIsCoeff(p) ? q : p, deg);
+        Poly result = PolyMulByCoeff(&truncated, PolyIsCoeff(p) ? p : q);
+        PolyDestroy(&truncated);
+        return result;
+    }
+
+    poly_exp_t *q_low = malloc(q->size * sizeof(poly_exp_t));
+    CHECK_PTR(q_low);
+
+    for (size_t j = 0; j < q->size; j++) {
+        q_low[j] = PolyLowDeg(&q->arr[j].p);
+    }
+
+    PolyAccumulator acc = PolyAccumulatorInit();
+
+    for (size_t i = 0; i < p->size; i++) {
+        poly_exp_t p_exp = MonoGetExp(&p->arr[i]);
+        poly_exp_t p_low = p_exp + PolyLowDeg(&p->arr[i].p);
+        PolyBuilder b = PolyBuilderInit(0);
+
+        for (size_t j = 0; j < q->size &&
+                           p_exp + MonoGetExp(&q->arr[j]) <= deg; j++) {
+            poly_exp_t exp = p_exp + MonoGetExp(&q->arr[j]);
+
+            // iloczyn dzieci nie ma jednomianu dość małego stopnia
+            if (p_low + MonoGetExp(&q->arr[j]) + q_low[j] > deg) {
+                continue;
+            }
+
+            Mono m = {.p = PolyMulTrunc(&p->arr[i].p, &q->arr[j].p, deg - exp),
+                      .exp = exp};
+            PolyBuilderAdd(&b, &m);
+        }
+
+        Poly row = PolyBuilderFinish(&b);
+        PolyAccumulatorAddOwned(&acc, &row);
+    }
+
+    free(q_low);
+    return PolyAccumulatorFinish(&acc);
+}
+
+/**
+ * Podnosi liść do kwadratu, licząc iloczyny współczynników tylko dla par
+ * @f$i \le j@f$ i podwajając iloczyny spoza przekątnej.
+ * @param[in] p : liść
+ * @return @f$p^2@f$
+ */
+static Poly PolySqrLeaf(const Poly *p) {
+    PolyBuilder b = PolyBuilderInit(p->size * (p->size + 1) / 2);
+
+    for (size_t i = 0; i < p->size; i++) {
+        poly_coeff_t c = p->arr[i].p.coeff;
+        Poly twice = CoeffSum(c, c);
+        Mono m = {.p = CoeffProduct(c, c), .exp = 2 * MonoGetExp(&p->arr[i])};
+        PolyBuilderAdd(&b, &m);
+
+        for (size_t j = i + 1; j < p->size; j++) {
+            m = (Mono) {.p = CoeffMulPoly(&twice, &p->arr[j].p),
+                        .exp = MonoGetExp(&p->arr[i]) + MonoGetExp(&p->arr[j])};
+            PolyBuilderAdd(&b, &m);
+        }
+        PolyDestroy(&twice);
+    }
+
+    return PolyBuilderFinish(&b);
+}
+
+/**
+ * Podnosi do kwadratu wielomian o wyliczonym już rodzaju.
+ * @param[in] p : wielomian
+ * @param[in] kind : rodzaj wielomianu @p p
+ * @return @f$p^2@f$
+ */
+static Poly PolySqrKind(const Poly *p, unsigned kind) {
+    if (PolyIsCoeff(p)) {
+        return CoeffMulPoly(p, p);
+    }
+    else if (kind & POLY_LEAF) {
+        return PolySqrLeaf(p);
+    }
+
+    // wiersz i: p_i^2 x^(2 e_i), a potem 2 p_i p_j x^(e_i + e_j) dla j > i,
+    // więc wykładniki w wierszu rosną
+    unsigned *kinds = PolyChildKinds(p);
+    PolyAccumulator acc = PolyAccumulatorInit();
+
+    for (size_t i = 0; i < p->size; i++) {
+        PolyBuilder b = PolyBuilderInit(p->size - i);
+        Mono m = {.p = PolySqrKind(&p->arr[i].p, kinds[i]),
+                  .exp = 2 * MonoGetExp(&p->arr[i])};
+        PolyBuilderAdd(&b, &m);
+
+        for (size_t j = i + 1; j < p->size; j++) {
+            m = (Mono) {.p = PolyMulKinds(&p->arr[i].p, kinds[i],
+                                          &p->arr[j].p, kinds[j]),
+                        .exp = MonoGetExp(&p->arr[i]) + MonoGetExp(&p->arr[j])};
+            PolyScaleInPlace(&m.p, 2);
+            PolyBuilderAdd(&b, &m);
+        }
+
+        Poly row = PolyBuilderFinish(&b);
+        PolyAccumulatorAddOwned(&acc, &row);
+    }
+
+    free(kinds);
+    return PolyAccumulatorFinish(&acc);
+}
+
+Poly PolySqr(const Poly *p) {
+    return PolySqrKind(p, PolyKind(p));
+}
+
+/**
+ * Zmienia znak wielomianu bez sprawdzania, czy współczynniki stają się
+ * zerowe. Poza trybem modularnym negacja jest różnowartościowa, więc
+ * wynik ma ten sam kształt co @p p i może być budowany bez kompaktowania.
+ * @param[in] p : wielomian
+ * @return @f$-p@f$
+ */
+static Poly PolyNegHelp(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return CoeffNegPoly(p);
+    }
+
+    Poly r = {.size = p->size, .arr = malloc(p->size * sizeof(Mono))};
+    CHECK_PTR(r.arr);
+
+    for (size_t i = 0; i < p->size; i++) {
+        const Poly *child = &p->arr[i].p;
+        r.arr[i].p = CoeffIsWord(child) ? CoeffNegation(child->coeff)
+                                        : PolyNegHelp(child);
+        r.arr[i].exp = p->arr[i].exp;
+    }
+
+    return r;
+}
+
+Poly PolyNeg(const Poly *p) {
+    if (modulus != 0) {
+        Poly minus_one = PolyFromCoeff(-1);
+        return PolyMulByCoeff(p, &minus_one);
+    }
+    else {
+        return PolyNegHelp(p);
+    }
+}
+
+/**
+ * Zmienia znak wielomianu w miejscu; jak w PolyNegHelp kształt wielomianu
+ * się nie zmienia.
+ * @param[in,out] p : wielomian
+ */
+static void PolyNegInPlaceHelp(Poly *p) {
+    if (PolyIsCoeff(p)) {
+        Poly r = CoeffNegPoly(p);
+        PolyDestroy(p);
+        *p = r;
+    }
+    else {
+        for (size_t i = 0; i < p->size; i++) {
+            PolyNegInPlaceHelp(&p->arr[i].p);
+        }
+    }
+}
+
+void PolyNegInPlace(Poly *p) {
+    if (modulus != 0) {
+        PolyScaleInPlace(p, -1);
+    }
+    else {
+        PolyNegInPlaceHelp(p);
+    }
+}
+
+/**
+ * Mnoży wielomian w miejscu przez stałą, usuwając jednomiany, których
+ * współczynniki stały się zerowe. Nie zmniejsza tablic jednomianów.
+ * @param[in,out] p : wielomian
+ * @param[in] coeff : stała, być może liczba wielka
+ */
+static void PolyScaleInPlaceHelp(Poly *p, const Poly *coeff) {
+    if (PolyIsCoeff(p)) {
+        Poly r = CoeffMulPoly(p, coeff);
+        PolyDestroy(p);
+        *p = r;
+        return;
+    }
+
+    size_t size = 0;
+    for (size_t i = 0; i < p->size; i++) {
+        PolyScaleInPlaceHelp(&p->arr[i].p, coeff);
+
+        if (!PolyIsZero(&p->arr[i].p)) {
+            p->arr[size++] = p->arr[i];
+        }
+    }
+
+    if (size == 0) {
+        free(p->arr);
+        *p = PolyZero();
+    }
+    else {
+        p->size = size;
+        *p = PolyNormalize(*p);
+    }
+}
+
+void PolyScaleInPlace(Poly *p, poly_coeff_t coeff) {
+    if (coeff == 1 && modulus == 0) {
+        return;
+    }
+    else if (coeff == -1 && modulus == 0) {
+        PolyNegInPlaceHelp(p);
+    }
+    else {
+        Poly c = PolyFromCoeff(coeff);
+        PolyScaleInPlaceHelp(p, &c);
+    }
+}
+
+/**
+ * Mnoży wielomian w miejscu przez stałą, która może być liczbą wielką.
+ * @param[in,out] p : wielomian
+ * @param[in] coeff : stała
+ */
+static void PolyScaleInPlaceBy(Poly *p, const Poly *coeff) {
+    if (CoeffIsWord(coeff)) {
+        PolyScaleInPlace(p, coeff->coeff);
+    }
+    else {
+        PolyScaleInPlaceHelp(p, coeff);
+    }
+}
+
+/**
+ * Mnoży wielomian w miejscu przez jednomian, przesuwając wykładniki na
+ * kolejnych poziomach.
+ * @param[in,out] p : wielomian
+ * @param[in] m : jednomian
+ */
+static void PolyMulByMonomialInPlace(Poly *p, const Poly *m) {
+    if (PolyIsCoeff(m)) {
+        PolyScaleInPlaceBy(p, m);
+        return;
+    }
+    else if (PolyIsZero(p)) {
+        return;
+    }
+    else if (PolyIsCoeff(p)) {
+        Poly r = PolyMulByCoeff(m, p);
+        PolyDestroy(p);
+        *p = r;
+        return;
+    }
+
+    poly_exp_t shift = MonoGetExp(&m->arr[0]);
+    size_t size = 0;
+
+    for (size_t i = 0; i < p->size; i++) {
+        PolyMulByMonomialInPlace(&p->arr[i].p, &m->arr[0].p);
+
+        // w trybie modularnym iloczyn może się wyzerować
+        if (!PolyIsZero(&p->arr[i].p)) {
+            p->arr[size].p = p->arr[i].p;
+            p->arr[size].exp = p->arr[i].exp + shift;
+            size++;
+        }
+    }
+
+    p->size = size;
+    if (size == 0) {
+        free(p->arr);
+        *p = PolyZero();
+    }
+    else {
+        *p = PolyNormalize(*p);
+    }
+}
+
+void PolyMulInPlace(Poly *p, const Poly *q) {
+    unsigned q_kind = PolyKind(q);
+
+    if (q_kind & POLY_MONOMIAL) {
+        PolyMulByMonomialInPlace(p, q);
+    }
+    else {
+        Poly r = PolyMulKinds(p, PolyKind(p), q, q_kind);
+        PolyDestroy(p);
+        *p = r;
+    }
+}
+
+Poly PolyReduce(const Poly *p) {
+    Poly one = PolyFromCoeff(1);
+    return PolyMulByCoeff(p, &one);
+}
+
+Poly PolySub(const Poly *p, const Poly *q) {
+    Poly r = PolyNeg(q);
+    Poly result = PolyAdd(p, &r);
+    PolyDestroy(&r);
+    return result;
+}
+
+/**
+ * Schodzi w rekurencji do interesującego nas miejsca (czyli aż @p var_idx = 0),
+ * po czym odczytuje największy wykładnik na tej głębokości. Wykładniki są
+ * posortowane rosnąco, więc jest to wykładnik ostatniego jednomianu.
+ * @param[in] p : wielomian
+ * @param[in] var_idx : głębokość rekurencji
+ * @return stopień wielomianu @p p z względu na zmienną o indeksie @p var_idx
+ */
+static poly_exp_t PolyDegByHelp(const Poly *p, size_t var_idx) {
+    if (PolyIsZero(p)) {
+        return -1;
+    }
+    else if (PolyIsCoeff(p)) {
+        return 0;
+    }
+    else if (var_idx == 0) {
+        return MonoGetExp(&p->arr[p->size - 1]);
+    }
+
+    poly_exp_t max = 0;
+
+    for (size_t i = 0; i < p->size; i++) {
+        poly_exp_t deg = PolyDegByHelp(&p->arr[i].p, var_idx - 1);
+
+        if (deg > max) {
+            max = deg;
+        }
+    }
+
+    return max;
+}
+
+poly_exp_t PolyDegBy(const Poly *p, size_t var_idx) {
+    return PolyDegByHelp(p, var_idx);
+}
+
+/**
+ * Schodzi w rekurencji najniżej jak się da aktualizując przy tym @p tmp,
+ * a na końcu aktualizuje @p max jeśli znaleźliśmy większy stopień.
+ * @param[in] p : wielomian
+ * @param[in] max : maksymalna suma wykładników
+ * @param[in] tmp : aktualna suma wykładników
+ */
+static void PolyDegHelp(const Poly *p, poly_exp_t *max, poly_exp_t *tmp) {
+    if (PolyIsLeaf(p)) {
+        poly_exp_t deg = *tmp + MonoGetExp(&p->arr[p->size - 1]);
+
+        if (deg > *max) {
+            *max = deg;
+        }
+    }
+    else if (!PolyIsCoeff(p)) {
+        for (size_t i = 0; i < p->size; i++) {
+            *tmp += MonoGetExp(&p->arr[i]);
+
+            if (*tmp > *max) {
+                *max = *tmp;
+            }
+
+            PolyDegHelp(&p->arr[i].p, max, tmp);
+            *tmp -= MonoGetExp(&p->arr[i]);
+        }
+    }
+}
+
+poly_exp_t PolyDeg(const Poly *p) {
+    if (PolyIsZero(p)) {
+        return -1;
+    }
+    else if (PolyIsCoeff(p)) {
+        return 0;
+    }
+    else if (PolyIsLeaf(p)) {
+        return MonoGetExp(&p->arr[p->size - 1]);
+    }
+    else {
+        poly_exp_t max = 0;
+
+        for (size_t i = 0; i < p->size; i++) {
+            poly_exp_t tmp = MonoGetExp(&p->arr[i]);
+            PolyDegHelp(&p->arr[i].p, &max, &tmp);
+
+            if (tmp > max) {
+                max = tmp;
+            }
+        }
+
+        return max;
+    }
+}
+
+/**
+ * Przechodzi wielomian w PolyDegVector, aktualizując stopnie ze względu na
+ * zmienne, stopień całkowity i liczbę zmiennych.
+ * @param[in] p : niezerowy wielomian
+ * @param[in] var_idx : indeks zmiennej głównej wielomianu @p p
+ * @param[in] tmp : suma wykładników na ścieżce od korzenia do @p p
+ * @param[in,out] out : tablica stopni ze względu na kolejne zmienne
+ * @param[in] k : rozmiar tablicy @p out
+ * @param[in,out] max : maksymalna suma wykładników
+ * @param[in,out] vars : liczba zmiennych
+ */
+static void PolyDegVectorHelp(const Poly *p, size_t var_idx, poly_exp_t tmp,
+                              poly_exp_t out[], size_t k, poly_exp_t *max,
+                              size_t *vars) {
+    if (PolyIsCoeff(p)) {
+        if (tmp > *max) {
+            *max = tmp;
+        }
+        return;
+    }
+
+    poly_exp_t last_exp = MonoGetExp(&p->arr[p->size - 1]);
+
+    if (var_idx < k && last_exp > out[var_idx]) {
+        out[var_idx] = last_exp;
+    }
+    if (last_exp > 0 && var_idx + 1 > *vars) {
+        *vars = var_idx + 1;
+    }
+
+    for (size_t i = 0; i < p->size; i++) {
+        PolyDegVectorHelp(&p->arr[i].p, var_idx + 1,
+                          tmp + MonoGetExp(&p->arr[i]), out, k, max, vars);
+    }
+}
+
+size_t PolyDegVector(const Poly *p, poly_exp_t out[], size_t k,
+                     poly_exp_t *deg) {
+    poly_exp_t max = PolyIsZero(p) ? -1 : 0;
+    size_t vars = 0;
+
+    for (size_t i = 0; i < k; i++) {
+        out[i] = max;
+    }
+
+    if (!PolyIsZero(p)) {
+        PolyDegVectorHelp(p, 0, 0, out, k, &max, &vars);
+    }
+
+    if (deg != NULL) {
+        *deg = max;
+    }
+
+    return vars;
+}
+
+/**
+ * Zdejmuje z wielomianu łańcuch jednomianów postaci @f$(p, 0)@f$. Funkcje
+ * biblioteki takich łańcuchów wokół współczynników nie tworzą, ale mogą one
+ * pochodzić z wielomianów zbudowanych ręcznie.
+ * @param[in] p : wielomian
+ * @return wielomian pod łańcuchem
+ */
+static const Poly *PolyUnwrap(const Poly *p) {
+    while (!PolyIsCoeff(p) && p->size == 1 && MonoGetExp(&p->arr[0]) == 0) {
+        p = &p->arr[0].p;
+    }
+
+    return p;
+}
+
+bool PolyIsEq(const Poly *p, const Poly *q) {
+    if (PolyIsCoeff(p) && PolyIsCoeff(q))
+        return CoeffIsEq(p, q);
+
+    // tylko tu może się ukrywać zagłębiony współczynnik
+    if (PolyIsCoeff(p) || PolyIsCoeff(q)) {
+        p = PolyUnwrap(p);
+        q = PolyUnwrap(q);
+        return PolyIsCoeff(p) && PolyIsCoeff(q) && CoeffIsEq(p, q);
+    }
+
+    if (p->size != q->size)
+        return false;
+
+    // Najpierw tanie porównanie całego poziomu, dopiero potem rekurencja.
+    for (size_t i = 0; i < p->size; i++) {
+        const Poly *x = &p->arr[i].p;
+        const Poly *y = &q->arr[i].p;
+
+        if (MonoGetExp(&p->arr[i]) != MonoGetExp(&q->arr[i]))
+            return false;
+
+        if (PolyIsCoeff(x) || PolyIsCoeff(y)) {
+            if (!PolyIsEq(x, y))
+                return false;
+        }
+        else if (x->size != y->size) {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < p->size; i++) {
+        const Poly *x = &p->arr[i].p;
+        const Poly *y = &q->arr[i].p;
+
+        if (!PolyIsCoeff(x) && !PolyIsCoeff(y) && !PolyIsEq(x, y))
+            return false;
+    }
+
+    return true;
+}
+
+/**
+ * Mnoży dwie liczby modulo EVAL_PRIME.
+ * @param[in] a : liczba z przedziału @f$[0, P)@f$
+ * @param[in] b : liczba z przedziału @f$[0, P)@f$
+ * @return @f$a \cdot b \bmod P@f$
+ */
+static uint64_t MulModPrime(uint64_t a, uint64_t b) {
+    unsigned __int128 r = (unsigned __int128) a * b;
+    uint64_t result = (uint64_t) (r & EVAL_PRIME) + (uint64_t) (r >> 61);
+    return result >= EVAL_PRIME ? result - EVAL_PRIME : result;
+}
+
+/**
+ * Podnosi liczbę do potęgi modulo EVAL_PRIME.
+ * @param[in] x : podstawa z przedziału @f$[0, P)@f$
+ * @param[in] exp : wykładnik
+ * @return @f$x^{exp} \bmod P@f$
+ */
+static uint64_t PowerModPrime(uint64_t x, poly_exp_t exp) {
+    uint64_t result = 1;
+
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            result = MulModPrime(result, x);
+        }
+        x = MulModPrime(x, x);
+        exp /= 2;
+    }
+
+    return result;
+}
+
+/**
+ * Sprowadza współczynnik do przedziału @f$[0, P)@f$.
+ * @param[in] c : współczynnik
+ * @return @f$c \bmod P@f$
+ */
+static uint64_t CoeffModPrime(poly_coeff_t c) {
+    if (sizeof(poly_coeff_t) > sizeof(int64_t)) {
+        c %= (poly_coeff_t) EVAL_PRIME;
+    }
+
+    int64_t r = (int64_t) c % (int64_t) EVAL_PRIME;
+    return r < 0 ? (uint64_t) (r + (int64_t) EVAL_PRIME) : (uint64_t) r;
+}
+
+/**
+ * Generator liczb pseudolosowych splitmix64.
+ * @param[in] x : ziarno
+ * @return pseudolosowa liczba wyznaczona przez @p x
+ */
+static uint64_t SplitMix64(uint64_t x) {
+    x += UINT64_C(0x9E3779B97F4A7C15);
+    x = (x ^ (x >> 30)) * UINT64_C(0xBF58476D1CE4E5B9);
+    x = (x ^ (x >> 27)) * UINT64_C(0x94D049BB133111EB);
+    return x ^ (x >> 31);
+}
+
+/**
+ * Wylicza wartość wielomianu modulo EVAL_PRIME w punkcie wyznaczonym przez
+ * @p seed. Wartość zmiennej @f$x_i@f$ zależy tylko od @p seed i @f$i@f$.
+ * @param[in] p : wielomian
+ * @param[in] seed : ziarno punktu
+ * @param[in] var_idx : indeks zmiennej głównej wielomianu @p p
+ * @return wartość wielomianu @p p w punkcie modulo @f$P@f$
+ */
+static uint64_t PolyEvalModPrime(const Poly *p, uint64_t seed, size_t var_idx) {
+    if (CoeffIsWord(p)) {
+        return CoeffModPrime(p->coeff);
+    }
+    else if (PolyIsCoeff(p)) {
+        return CoeffResidue(p, EVAL_PRIME);
+    }
+
+    uint64_t x = SplitMix64(seed + var_idx) % EVAL_PRIME;
+    uint64_t power = 1;
+    uint64_t result = 0;
+    poly_exp_t last_exp = 0;
+
+    for (size_t i = 0; i < p->size; i++) {
+        power = MulModPrime(power,
+                            PowerModPrime(x, MonoGetExp(&p->arr[i]) - last_exp));
+        last_exp = MonoGetExp(&p->arr[i]);
+        result += MulModPrime(PolyEvalModPrime(&p->arr[i].p, seed, var_idx + 1),
+                              power);
+        if (result >= EVAL_PRIME) {
+            result -= EVAL_PRIME;
+        }
+    }
+
+    return result;
+}
+
+bool PolyIsEqProbable(const Poly *p, const Poly *q, unsigned rounds) {
+    static uint64_t state = UINT64_C(0x5DEECE66D);
+
+    for (unsigned i = 0; i < rounds; i++) {
+        state = SplitMix64(state);
+
+        if (PolyEvalModPrime(p, state, 0) != PolyEvalModPrime(q, state, 0)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+uint64_t PolyHash(const Poly *p) {
+    return PolyEvalModPrime(p, HASH_SEED, 0);
+}
+
+uint64_t PolyHashAdd(uint64_t hp, uint64_t hq) {
+    uint64_t result = hp + hq;
+    return result >= EVAL_PRIME ? result - EVAL_PRIME : result;
+}
+
+uint64_t PolyHashNeg(uint64_t hp) {
+    return hp == 0 ? 0 : EVAL_PRIME - hp;
+}
+
+uint64_t PolyHashMul(uint64_t hp, uint64_t hq) {
+    return MulModPrime(hp, hq);
+}
+
+/**
+ * Podnosi stałą @p x do potęgi @p exp.
+ * @param[in] x : stała
+ * @param[in] exp : wykładnik
+ * @return @f$x^{exp}@f$
+ */
+static poly_coeff_t Power(poly_coeff_t x, poly_exp_t exp) {
+    if (exp == 0) {
+        return 1;
+    }
+    else if (exp % 2 == 0) {
+        poly_coeff_t y = Power(x, exp / 2);
+        return CoeffMul(y, y);
+    }
+    else {
+        poly_coeff_t y = Power(x, exp - 1);
+        return CoeffMul(x, y);
+    }
+}
+
+/**
+ * Podnosi współczynnik, który może być liczbą wielką, do potęgi przez
+ * kolejne podnoszenie do kwadratu.
+ * @param[in] x : współczynnik
+ * @param[in] exp : wykładnik
+ * @return @f$x^{exp}@f$
+ */
+static Poly CoeffPower(const Poly *x, poly_exp_t exp) {
+    Poly result = PolyFromCoeff(1);
+    Poly base = CoeffClone(x);
+
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            Poly product = CoeffMulPoly(&result, &base);
+            PolyDestroy(&result);
+            result = product;
+        }
+
+        exp /= 2;
+
+        if (exp > 0) {
+            Poly square = CoeffMulPoly(&base, &base);
+            PolyDestroy(&base);
+            base = square;
+        }
+    }
+
+    PolyDestroy(&base);
+    return result;
+}
+
+/**
+ * Wylicza wartość liścia w punkcie @p x. Wykładniki są posortowane rosnąco,
+ * więc kolejne potęgi @p x liczone są przyrostowo z poprzednich. Rodzaj
+ * wielomianu sprawdzany jest w tym samym przejściu: przy pierwszym
+ * współczynniku, który nie jest liczbą, funkcja przerywa.
+ * @param[in] p : wielomian niebędący współczynnikiem
+ * @param[in] x : wartość argumentu
+ * @param[out] result : @f$p(x)@f$, jeśli @p p jest liściem
+ * @return Czy @p p jest liściem?
+ */
+static bool PolyAtLeaf(const Poly *p, poly_coeff_t x, poly_coeff_t *result) {
+    poly_coeff_t power = 1;
+    poly_exp_t last_exp = 0;
+    *result = 0;
+
+    for (size_t i = 0; i < p->size; i++) {
+        if (!CoeffIsWord(&p->arr[i].p)) {
+            return false;
+        }
+
+        power = CoeffMul(power, Power(x, MonoGetExp(&p->arr[i]) - last_exp));
+        last_exp = MonoGetExp(&p->arr[i]);
+        *result = CoeffAdd(*result, CoeffMul(p->arr[i].p.coeff, power));
+    }
+
+    return true;
+}
+
+Poly PolyAt(const Poly *p, poly_coeff_t x) {
+    if (PolyIsCoeff(p)) {
+        return CoeffClone(p);
+    }
+
+    bool overflow = coeff_overflow;
+    coeff_overflow = false;
+    poly_coeff_t value;
+    bool leaf = PolyAtLeaf(p, x, &value);
+    bool wrapped = coeff_overflow;
+    coeff_overflow = overflow;
+
+    // w trybie dokładnym przepełniony wynik liczony jest od nowa niżej
+    if (leaf && (!wrapped || !exact_coeffs)) {
+        coeff_overflow |= wrapped;
+        return PolyFromCoeff(value);
+    }
+
+    PolyAccumulator acc = PolyAccumulatorInit();
+    Poly base = PolyFromCoeff(x);
+
+    for (size_t i = 0; i < p->size; i++) {
+        Poly power = CoeffPower(&base, MonoGetExp(&p->arr[i]));
+        Poly term = PolyMulByCoeff(&p->arr[i].p, &power);
+        PolyDestroy(&power);
+        PolyAccumulatorAddOwned(&acc, &term);
+    }
+
+    return PolyAccumulatorFinish(&acc);
+}
+
+/**
+ * Podnosi wielomian @p p do potęgi @p exp.
+ * @param[in] p : wielomian
+ * @param[in] kind : rodzaj wielomianu @p p
+ * @param[in] exp : wykładnik
+ * @return @f$p^{exp}@f$
+ */
+static Poly PolyPower(const Poly *p, unsigned kind, poly_exp_t exp) {
+    if (exp == 0) {
+        return PolyFromCoeff(1);
+    }
+    else if (exp % 2 == 0) {
+        Poly q = PolyPower(p, kind, exp / 2);
+        Poly result = PolySqr(&q);
+        PolyDestroy(&q);
+        return result;
+    }
+    else {
+        Poly q = PolyPower(p, kind, exp - 1);
+        Poly result = PolyMulKinds(p, kind, &q, PolyKind(&q));
+        PolyDestroy(&q);
+        return result;
+    }
+}
+
+/**
+ * Podnosi współczynnik do potęgi bez zapamiętywania przepełnienia.
+ * @param[in] x : współczynnik
+ * @param[in] exp : wykładnik
+ * @param[out] result : @f$x^{exp}@f$
+ * @return czy obyło się bez przepełnienia
+ */
+static bool PowerExact(poly_coeff_t x, poly_exp_t exp, poly_coeff_t *result) {
+    poly_coeff_t y = 1;
+
+    while (exp > 0) {
+        if (exp % 2 == 1 && __builtin_mul_overflow(y, x, &y)) {
+            return false;
+        }
+
+        exp /= 2;
+
+        if (exp > 0 && __builtin_mul_overflow(x, x, &x)) {
+            return false;
         }
-        free(p->arr);
     }
- }
 
-Poly PolyClone(const Poly *p) {
-    if (PolyIsCoeff(p)) {
-        return PolyFromCoeff(p->coeff);
+    *result = y;
+    return true;
+}
+
+/**
+ * Podnosi gęsty liść do potęgi rekurencją J.C.P. Millera. Dla
+ * @f$p = x^{e}(a_0 + a_1 x + \ldots + a_d x^d)@f$ współczynniki
+ * @f$q = p^n / x^{ne}@f$ spełniają
+ * @f$k a_0 q_k = \sum_{j=1}^{\min(k,d)} ((n+1)j - k) a_j q_{k-j}@f$,
+ * więc całość kosztuje @f$O(nd)@f$ operacji na każdy wyraz @p p.
+ * Działa na dokładnych liczbach całkowitych; jeśli któryś krok by się
+ * przepełnił, nie zwraca wyniku i trzeba użyć zwykłego potęgowania.
+ * @param[in] p : liść
+ * @param[in] exp : wykładnik @f$n \ge 1@f$
+ * @param[out] result : @f$p^n@f$
+ * @return czy udało się wyliczyć wynik
+ */
+static bool PolyPowMiller(const Poly *p, poly_exp_t exp, Poly *result) {
+    poly_exp_t low = MonoGetExp(&p->arr[0]);
+    poly_exp_t deg = MonoGetExp(&p->arr[p->size - 1]) - low;
+    poly_exp_t len;
+    poly_exp_t shift;
+    poly_exp_t top;
+
+    if (__builtin_mul_overflow(exp, deg, &len) ||
+        __builtin_mul_overflow(exp, low, &shift) ||
+        __builtin_add_overflow(len, shift, &top)) {
+        return false;
     }
 
-    Poly q = (Poly) {.size = p->size, .arr = malloc(q.size * sizeof(Mono))};
-    CHECK_PTR(&q.arr);
+    poly_coeff_t a0 = p->arr[0].p.coeff;
+    poly_coeff_t *q = malloc(((size_t) len + 1) * sizeof(poly_coeff_t));
+    CHECK_PTR(q);
 
-    for (size_t i = 0; i < q.size; i++) {
-        q.arr[i] = MonoClone(&p->arr[i]);
+    if (!PowerExact(a0, exp, &q[0])) {
+        free(q);
+        return false;
     }
 
-    return q;
+    for (size_t k = 1; k <= (size_t) len; k++) {
+        poly_coeff_t sum = 0;
+
+        for (size_t j = 1; j < p->size; j++) {
+            size_t d = (size_t) (MonoGetExp(&p->arr[j]) - low);
+            poly_coeff_t term;
+
+            if (d > k) {
+                break;
+            }
+            else if (__builtin_mul_overflow((size_t) exp + 1, d, &term) ||
+                     __builtin_sub_overflow(term, k, &term) ||
+                     __builtin_mul_overflow(term, p->arr[j].p.coeff, &term) ||
+                     __builtin_mul_overflow(term, q[k - d], &term) ||
+                     __builtin_add_overflow(sum, term, &sum)) {
+                free(q);
+                return false;
+            }
+        }
+
+        poly_coeff_t divisor;
+
+        if (__builtin_mul_overflow(k, a0, &divisor)) {
+            free(q);
+            return false;
+        }
+
+        assert(sum % divisor == 0);
+        q[k] = sum / divisor;
+    }
+
+    PolyBuilder b = PolyBuilderInit(0);
+
+    for (size_t k = 0; k <= (size_t) len; k++) {
+        Mono m = {.p = PolyFromCoeff(q[k]), .exp = shift + (poly_exp_t) k};
+        PolyBuilderAdd(&b, &m);
+    }
+
+    free(q);
+    *result = PolyBuilderFinish(&b);
+    return true;
 }
 
 /**
- * Porównuje dwie wartości.
- * @param[in] a
- * @param[in] b
- * @return Jeśli @f$a<b@f$ zwraca -1, jeśli @f$a=b@f$ zwraca 0,
- * jeśli @f$a=b@f$ zwraca -1.
+ * Podnosi dwuwyrazowy wielomian @f$b x^{e_0} + a x^{e_1}@f$ do potęgi
+ * ze wzoru dwumianowego. Kolejne wyrazy mają rosnące wykładniki
+ * @f$k e_1 + (n-k) e_0@f$, a potęgi @f$a^k@f$ i @f$b^{n-k}@f$ liczone są
+ * przyrostowo. Jeśli któryś współczynnik dwumianowy się nie mieści,
+ * nie zwraca wyniku i trzeba użyć zwykłego potęgowania.
+ * @param[in] p : wielomian o dwóch jednomianach
+ * @param[in] exp : wykładnik @f$n \ge 1@f$
+ * @param[out] result : @f$p^n@f$
+ * @return czy udało się wyliczyć wynik
  */
-static int ExpComparator(const void *a, const void *b) {
-    Mono x = *(Mono *) a;
-    Mono y = *(Mono *) b;
+static bool PolyPowBinomial(const Poly *p, poly_exp_t exp, Poly *result) {
+    poly_coeff_t binomial = 1;
 
-    if (MonoGetExp(&x) < MonoGetExp(&y)) {
-        return -1;
+    for (poly_exp_t k = 0; k < exp; k++) {
+        if (__builtin_mul_overflow(binomial, (poly_coeff_t) (exp - k),
+                                   &binomial)) {
+            return false;
+        }
+
+        binomial /= k + 1;
     }
-    else if (MonoGetExp(&x) == MonoGetExp(&y)) {
-        return 0;
+
+    poly_coeff_t *binomials = malloc(((size_t) exp + 1) * sizeof(poly_coeff_t));
+    CHECK_PTR(binomials);
+    binomials[0] = 1;
+
+    for (poly_exp_t k = 0; k < exp; k++) {
+        binomials[k + 1] = binomials[k] * (exp - k) / (k + 1);
     }
-    else {
-        return 1;
+
+    const Poly *a = &p->arr[1].p;
+    const Poly *b = &p->arr[0].p;
+    Poly *b_powers = malloc(((size_t) exp + 1) * sizeof(Poly));
+    CHECK_PTR(b_powers);
+    b_powers[0] = PolyFromCoeff(1);
+
+    for (poly_exp_t k = 1; k <= exp; k++) {
+        b_powers[k] = PolyMul(&b_powers[k - 1], b);
+    }
+
+    PolyBuilder builder = PolyBuilderInit((size_t) exp + 1);
+    Poly a_power = PolyFromCoeff(1);
+
+    for (poly_exp_t k = 0; k <= exp; k++) {
+        Mono m = {.p = PolyMul(&a_power, &b_powers[exp - k]),
+                  .exp = k * MonoGetExp(&p->arr[1]) +
+                         (exp - k) * MonoGetExp(&p->arr[0])};
+        PolyScaleInPlace(&m.p, binomials[k]);
+        PolyBuilderAdd(&builder, &m);
+        PolyDestroy(&b_powers[exp - k]);
+
+        if (k < exp) {
+            PolyMulInPlace(&a_power, a);
+        }
     }
+
+    PolyDestroy(&a_power);
+    free(b_powers);
+    free(binomials);
+    *result = PolyBuilderFinish(&builder);
+    return true;
 }
 
 /**
- * Sortuje listę jednomianów.
- * @param[in] monos : tablica jednomianów
- * @param[in] count : liczba jednomianów
+ * Podnosi jednomian do potęgi: współczynnik jest potęgowany, a wykładniki
+ * na wszystkich poziomach mnożone przez @p exp.
+ * @param[in] m : jednomian
+ * @param[in] exp : wykładnik
+ * @return @f$m^{exp}@f$
  */
-static void SortMonos(Mono monos[], size_t count) {
-    qsort(monos, count, sizeof(Mono), ExpComparator);
+static Poly PolyPowMonomial(const Poly *m, poly_exp_t exp) {
+    if (PolyIsCoeff(m)) {
+        return CoeffPower(m, exp);
+    }
+
+    Poly inner = PolyPowMonomial(&m->arr[0].p, exp);
+
+    if (PolyIsZero(&inner)) {
+        return inner;
+    }
+
+    Poly r = {.size = 1, .arr = malloc(sizeof(Mono))};
+    CHECK_PTR(r.arr);
+    r.arr[0] = (Mono) {.p = inner, .exp = MonoGetExp(&m->arr[0]) * exp};
+    return PolyNormalize(r);
 }
 
-bool PolyIsDeepCoeff(Poly *p) {
-    if (PolyIsCoeff(p)) {
-        return true;
+Poly PolyPow(const Poly *p, poly_exp_t exp) {
+    Poly result;
+
+    if (exp == 0) {
+        return PolyFromCoeff(1);
     }
-    else if (p->size == 1 && p->arr[0].exp == 0) {
-        return PolyIsDeepCoeff(&p->arr[0].p);
+
+    unsigned kind = PolyKind(p);
+
+    if (kind & POLY_MONOMIAL) {
+        return PolyPowMonomial(p, exp);
     }
-    else {
-        return false;
+    else if (p->size == 2 && PolyPowBinomial(p, exp, &result)) {
+        return result;
     }
-}
 
-poly_coeff_t PolyGetDeepCoeff(Poly *p) {
-    if (PolyIsCoeff(p)) {
-        return p->coeff;
-    }
-    else {
-        return PolyGetDeepCoeff(&p->arr[0].p);
+    // rekurencja Millera wymaga dzielenia, więc nie działa modulo
+    if (modulus == 0 && p->size > 2 && (kind & POLY_LEAF) &&
+        (size_t) (MonoGetExp(&p->arr[p->size - 1]) -
+                  MonoGetExp(&p->arr[0])) < 4 * p->size &&
+        PolyPowMiller(p, exp, &result)) {
+        return result;
     }
+
+    return PolyPower(p, kind, exp);
 }
 
 /**
- * Upraszcza wielomian do współczynnika (jeśli jest zagłębionym współczynnikiem).
+ * PolyPowTrunc dla wielomianu o wyliczonym już rodzaju, przekazywanym
+ * bez zmian do kolejnych kroków rekurencji.
  * @param[in] p : wielomian
- * @return uproszczony wielomian
+ * @param[in] kind : rodzaj wielomianu @p p
+ * @param[in] exp : wykładnik
+ * @param[in] deg : największy zachowany stopień łączny
+ * @return @f$p^{exp}@f$ obcięte do stopnia @p deg
  */
-static Poly PolyToCoeff(Poly *p) {
-    if (PolyIsZero(p)) {
-        PolyDestroy(p);
+static Poly PolyPowTruncKind(const Poly *p, unsigned kind, poly_exp_t exp,
+                             poly_exp_t deg) {
+    poly_exp_t low;
+
+    if (deg < 0 || (exp > 0 && PolyIsZero(p))) {
         return PolyZero();
     }
-    else if (!PolyIsCoeff(p) && PolyIsDeepCoeff(p)) {
-        poly_coeff_t coeff = PolyGetDeepCoeff(p);
-        return PolyFromCoeff(coeff);
+    else if (exp == 0) {
+        return PolyFromCoeff(1);
     }
-    else {
-        return *p;
+    else if (__builtin_mul_overflow(PolyLowDeg(p), exp, &low) || low > deg) {
+        return PolyZero();
     }
-}
-
-Poly PolyAdd(const Poly *p, const Poly *q) {
-    if (PolyIsZero(p)) {
-        Poly r = PolyClone(q);
-        return r;
+    else if (kind & POLY_MONOMIAL) { // cały jednomian ma stopień low
+        return PolyPowMonomial(p, exp);
     }
-    else if (PolyIsZero(q)) {
-        Poly r = PolyClone(p);
-        return r;
+    else if (exp == 1) {
+        Poly result = PolyTruncate(p, deg);
+        PolyScaleInPlace(&result, 1); // w trybie modularnym redukuje kopię
+        return result;
     }
-    else if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
-        return PolyFromCoeff(p->coeff + q->coeff);
+    else if (exp % 2 == 0) {
+        Poly q = PolyPowTruncKind(p, kind, exp / 2, deg);
+        Poly result = PolyMulTrunc(&q, &q, deg);
+        PolyDestroy(&q);
+        return result;
     }
-    else if (PolyIsCoeff(p)) { // wydzielić do innej funkcji
-        Mono pom = (Mono) {.p = PolyClone(p), .exp = 0};
-        Poly r = (Poly) {.size = 1, .arr = malloc(sizeof(Mono))};
-        CHECK_PTR(&r.arr);
-        r.arr[0] = pom;
-
-        Poly result = PolyAdd(&r, q);
-        PolyDestroy(&r);
+    else {
+        Poly q = PolyPowTruncKind(p, kind, exp - 1, deg);
+        Poly result = PolyMulTrunc(p, &q, deg);
+        PolyDestroy(&q);
         return result;
     }
-    else if (PolyIsCoeff(q)) { // jak wyżej
-        Mono pom = (Mono) {.p = PolyClone(q), .exp = 0};
-        Poly r = (Poly) {.size = 1, .arr = malloc(sizeof(Mono))};
-        CHECK_PTR(&r.arr);
-        r.arr[0] = pom;
+}
 
-        Poly result = PolyAdd(p, &r);
-        PolyDestroy(&r);
-        return result;
+Poly PolyPowTrunc(const Poly *p, poly_exp_t exp, poly_exp_t deg) {
+    return PolyPowTruncKind(p, PolyKind(p), exp, deg);
+}
+
+/**
+ * PolyCompose z dodatkowym argumentem określającym, który wielomian z tablicy
+ * aktualnie wstawiamy.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów
+ * @param[in] idx : numer wielomianu z tablicy, który podstawiamy do @p p
+ * @param[in] q : tablica wielomianów
+ * @return @f$p(q_0, q_1, q_2, \ldots)@f$
+ */
+static Poly PolyComposeHelp(const Poly *p, size_t k, size_t idx, const Poly q[]) {
+    if (PolyIsCoeff(p)) {
+        return CoeffClone(p);
     }
     else {
-        Poly r = (Poly) {.size = p->size + q->size,
-                         .arr = malloc(r.size * sizeof(Mono))};
-        CHECK_PTR(&r.arr);
-        size_t index_p = 0, index_q = 0, index_r = 0;
+        PolyAccumulator acc = PolyAccumulatorInit();
+        Poly arg_first;
+        Poly arg_second;
 
-        while (index_p < p->size && index_q < q->size) {
-            if (MonoGetExp(&p->arr[index_p]) < MonoGetExp(&q->arr[index_q])) {
-                r.arr[index_r] = MonoClone(&p->arr[index_p]);
-                index_p++;
-                index_r++;
+        for (size_t i = 0; i < p->size; i++) {
+            if (idx < k) {
+                arg_second = PolyPow(&q[idx], p->arr[i].exp);
             }
-            else if (MonoGetExp(&p->arr[index_p]) > MonoGetExp(&q->arr[index_q])) {
-                r.arr[index_r] = MonoClone(&q->arr[index_q]);
-                index_q++;
-                index_r++;
+            else if (MonoGetExp(&p->arr[i]) == 0) {
+                arg_second = PolyFromCoeff(1);
             }
             else {
-                r.arr[index_r] = (Mono) {.exp = MonoGetExp(&p->arr[index_p]),
-                        .p = PolyAdd(&p->arr[index_p].p, &q->arr[index_q].p)};
-                if (PolyIsZero(&r.arr[index_r].p)) {
-                    PolyDestroy(&r.arr[index_r].p);
-                }
-                index_p++;
-                index_q++;
-                index_r++;
-                r.size--;
+                arg_second = PolyZero();
             }
-        }
-        while (index_p < p->size) {
-            r.arr[index_r] = MonoClone(&p->arr[index_p]);
-            index_p++;
-            index_r++;
-        }
-        while (index_q < q->size) {
-            r.arr[index_r] = MonoClone(&q->arr[index_q]);
-            index_q++;
-            index_r++;
-        }
-
-        Poly result = (Poly) {.size = r.size,
-                              .arr = malloc(r.size * sizeof(Mono))};
-        CHECK_PTR(&result.arr);
-        int index = 0;
 
-        for (size_t i = 0; i < r.size; i++) {
-            if (!PolyIsZero(&r.arr[i].p)) {
-                result.arr[index] = MonoClone(&r.arr[i]);
-                index++;
+            if (PolyIsCoeff(&p->arr[i].p)) {
+                PolyScaleInPlaceBy(&arg_second, &p->arr[i].p);
+                PolyAccumulatorAddOwned(&acc, &arg_second);
+            }
+            else {
+                arg_first = PolyComposeHelp(&p->arr[i].p, k, idx + 1, q);
+                Poly term = PolyMul(&arg_first, &arg_second);
+                PolyAccumulatorAddOwned(&acc, &term);
+                PolyDestroy(&arg_first);
+                PolyDestroy(&arg_second);
             }
         }
 
-        PolyDestroy(&r);
-        result.size = index;
+        return PolyAccumulatorFinish(&acc);
+    }
+}
 
-        if (result.size == 0) {
-            PolyDestroy(&result);
-            return PolyZero();
+Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
+    return PolyComposeHelp(p, k, 0, q);
+}
+
+/**
+ * PolyComposeTrunc z dodatkowym argumentem określającym, który wielomian
+ * z tablicy aktualnie wstawiamy.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów
+ * @param[in] idx : numer wielomianu z tablicy, który podstawiamy do @p p
+ * @param[in] q : tablica wielomianów
+ * @param[in] deg : największy zachowany stopień łączny
+ * @return @f$p(q_0, q_1, q_2, \ldots)@f$ bez jednomianów stopnia większego
+ * niż @p deg
+ */
+static Poly PolyComposeTruncHelp(const Poly *p, size_t k, size_t idx,
+                                 const Poly q[], poly_exp_t deg) {
+    if (PolyIsCoeff(p)) {
+        return CoeffClone(p);
+    }
+
+    poly_exp_t q_low = idx < k ? PolyLowDeg(&q[idx]) : 0;
+    PolyAccumulator acc = PolyAccumulatorInit();
+
+    for (size_t i = 0; i < p->size; i++) {
+        poly_exp_t exp = MonoGetExp(&p->arr[i]);
+        poly_exp_t low;
+        Poly power;
+
+        if (idx >= k && exp > 0) {
+            break;
+        }
+        // kolejne potęgi mają coraz większy najmniejszy stopień
+        else if (__builtin_mul_overflow(q_low, exp, &low) || low > deg) {
+            break;
+        }
+        else if (idx < k) {
+            power = PolyPowTrunc(&q[idx], exp, deg);
+        }
+        else {
+            power = PolyFromCoeff(1);
+        }
+
+        if (PolyIsCoeff(&p->arr[i].p)) {
+            PolyScaleInPlaceBy(&power, &p->arr[i].p);
+            PolyAccumulatorAddOwned(&acc, &power);
         }
         else {
-            result.arr = realloc(result.arr, result.size * sizeof(Mono));
-            CHECK_PTR(&result.arr);
-            return result;
+            Poly inner = PolyComposeTruncHelp(&p->arr[i].p, k, idx + 1, q,
+                                              deg - PolyLowDeg(&power));
+            Poly term = PolyMulTrunc(&inner, &power, deg);
+            PolyAccumulatorAddOwned(&acc, &term);
+            PolyDestroy(&inner);
+            PolyDestroy(&power);
         }
     }
+
+    return PolyAccumulatorFinish(&acc);
 }
 
-Poly PolyOwnMonos(size_t count, Mono *monos) {
-    if (count == 0 || monos == NULL) {
+Poly PolyComposeTrunc(const Poly *p, size_t k, const Poly q[], poly_exp_t deg) {
+    if (deg < 0) {
         return PolyZero();
     }
 
-    SortMonos(monos, count);
+    return PolyComposeTruncHelp(p, k, 0, q, deg);
+}
+
+/**
+ * Wykonuje krok przesunięcia Taylora @f$a \gets a + c \cdot b@f$.
+ * @param[in,out] a : wielomian @f$a@f$
+ * @param[in] b : wielomian @f$b@f$
+ * @param[in] c : stała @f$c@f$
+ */
+static void PolyShiftStep(Poly *a, const Poly *b, poly_coeff_t c) {
+    Poly factor = PolyFromCoeff(c);
+
+    if (PolyIsZero(b)) {
+        return;
+    }
+    else if (CoeffIsWord(a) && CoeffIsWord(b) && !exact_coeffs) {
+        a->coeff = CoeffAdd(a->coeff, CoeffMul(c, b->coeff));
+        return;
+    }
+
+    Poly scaled = PolyMulByCoeff(b, &factor);
+    Poly sum = PolyAdd(a, &scaled);
+    PolyDestroy(a);
+    PolyDestroy(&scaled);
+    *a = sum;
+}
+
+/**
+ * Podstawia @f$x + c@f$ za zmienną głównego poziomu gęstym schematem Hornera:
+ * dla @f$i = 0, \ldots, d - 1@f$ i @f$j = d - 1, \ldots, i@f$ wykonuje
+ * @f$a_j \gets a_j + c \cdot a_{j+1}@f$. Kosztuje @f$O(d^2)@f$ kroków dla
+ * stopnia @f$d@f$ i nie alokuje niczego poza tablicą współczynników.
+ * @param[in] p : wielomian niebędący współczynnikiem
+ * @param[in] c : przesunięcie
+ * @return @f$p(x + c)@f$
+ */
+static Poly PolyShiftDense(const Poly *p, poly_coeff_t c) {
+    poly_exp_t deg = MonoGetExp(&p->arr[p->size - 1]);
+    Poly *a = malloc(((size_t) deg + 1) * sizeof(Poly));
+    CHECK_PTR(a);
 
-    Poly result = (Poly) {.size = count, .arr = malloc(count * sizeof(Mono))};
-    CHECK_PTR(&result.arr);
-    result.arr[0] = MonoClone(&monos[0]);
-    int index = 0;
+    for (poly_exp_t j = 0; j <= deg; j++) {
+        a[j] = PolyZero();
+    }
+    for (size_t i = 0; i < p->size; i++) {
+        a[MonoGetExp(&p->arr[i])] = PolyClone(&p->arr[i].p);
+    }
 
-    for (size_t i = 1; i < count; i++) {
-        if (MonoGetExp(&result.arr[index]) == MonoGetExp(&monos[i])) {
-            Poly pom = PolyAdd(&result.arr[index].p, &monos[i].p);
-            PolyDestroy(&result.arr[index].p);
-            result.arr[index].p = pom;
-            result.size--;
+    for (poly_exp_t i = 0; i < deg; i++) {
+        for (poly_exp_t j = deg - 1; j >= i; j--) {
+            PolyShiftStep(&a[j], &a[j + 1], c);
         }
-        else if (PolyIsZero(&result.arr[index].p)) {
-            PolyDestroy(&result.arr[index].p);
-            result.arr[index] = MonoClone(&monos[i]);
-            result.size--;
+    }
+
+    PolyBuilder b = PolyBuilderInit((size_t) deg + 1);
+
+    for (poly_exp_t j = 0; j <= deg; j++) {
+        Mono m = {.p = a[j], .exp = j};
+        PolyBuilderAdd(&b, &m);
+    }
+
+    free(a);
+    return PolyBuilderFinish(&b);
+}
+
+/**
+ * Podstawia @f$x + c@f$ za zmienną głównego poziomu rzadkiego wielomianu,
+ * rozwijając każdy jednomian @f$a_i x^{e_i}@f$ osobno ze wzoru dwumianowego.
+ * Kosztuje @f$O(\sum_i e_i)@f$ zamiast @f$O(d^2)@f$.
+ * @param[in] p : wielomian niebędący współczynnikiem
+ * @param[in] c : przesunięcie
+ * @return @f$p(x + c)@f$
+ */
+static Poly PolyShiftSparse(const Poly *p, poly_coeff_t c) {
+    Mono linear[2] = {{.p = PolyFromCoeff(c), .exp = 0},
+                      {.p = PolyFromCoeff(1), .exp = 1}};
+    Poly shifted = {.size = 2, .arr = linear};
+    PolyAccumulator acc = PolyAccumulatorInit();
+
+    for (size_t i = 0; i < p->size; i++) {
+        Poly power = PolyPow(&shifted, MonoGetExp(&p->arr[i]));
+        Poly row;
+
+        if (PolyIsCoeff(&power)) {
+            row = PolyMulByCoeff(&p->arr[i].p, &power);
+            if (!PolyIsCoeff(&row)) { // wyraz wolny zależy od dalszych zmiennych
+                Poly wrapped = {.size = 1, .arr = malloc(sizeof(Mono))};
+                CHECK_PTR(wrapped.arr);
+                wrapped.arr[0] = (Mono) {.p = row, .exp = 0};
+                row = wrapped;
+            }
         }
         else {
-            index++;
-            result.arr[index] = MonoClone(&monos[i]);
+            PolyBuilder b = PolyBuilderInit(power.size);
+            for (size_t k = 0; k < power.size; k++) {
+                Mono m = {.p = PolyMulByCoeff(&p->arr[i].p, &power.arr[k].p),
+                          .exp = MonoGetExp(&power.arr[k])};
+                PolyBuilderAdd(&b, &m);
+            }
+            row = PolyBuilderFinish(&b);
         }
+
+        PolyDestroy(&power);
+        PolyAccumulatorAddOwned(&acc, &row);
     }
 
-    if (PolyIsZero(&result.arr[index].p)) {
-        MonoDestroy(&result.arr[index]);
-        result.size--;
+    return PolyAccumulatorFinish(&acc);
+}
+
+Poly PolyShift(const Poly *p, size_t var_idx, poly_coeff_t c) {
+    if (PolyIsCoeff(p) || c == 0) {
+        return PolyClone(p);
+    }
+    else if (var_idx == 0) {
+        poly_exp_t deg = MonoGetExp(&p->arr[p->size - 1]);
+        return 2 * p->size < (size_t) deg ? PolyShiftSparse(p, c)
+                                          : PolyShiftDense(p, c);
     }
 
-    for (size_t i = 0; i < count; i++) {
-        MonoDestroy(&monos[i]);
+    PolyBuilder b = PolyBuilderInit(p->size);
+
+    for (size_t i = 0; i < p->size; i++) {
+        Mono m = {.p = PolyShift(&p->arr[i].p, var_idx - 1, c),
+                  .exp = MonoGetExp(&p->arr[i])};
+        PolyBuilderAdd(&b, &m);
     }
-    free(monos);
 
-    if (result.size == 0) {
-        PolyDestroy(&result);
-        return PolyZero();
+    return PolyBuilderFinish(&b);
+}
+
+/**
+ * Struktura przechowująca policzone potęgi wielomianu, posortowane rosnąco
+ * po wykładnikach.
+ */
+typedef struct PowerCache {
+    const Poly *base; ///< potęgowany wielomian
+    poly_exp_t *exps; ///< wykładniki policzonych potęg
+    Poly *powers; ///< policzone potęgi
+    size_t size; ///< liczba policzonych potęg
+    size_t capacity; ///< rozmiar zaalokowanych tablic
+} PowerCache;
+
+/**
+ * Zwraca potęgę podstawy z pamięci podręcznej, licząc ją w razie potrzeby
+ * z największej już policzonej mniejszej potęgi.
+ * @param[in,out] cache : pamięć podręczna potęg
+ * @param[in] exp : wykładnik
+ * @return potęga podstawy, należąca do @p cache
+ */
+static const Poly *PowerCacheGet(PowerCache *cache, poly_exp_t exp) {
+    size_t pos = 0;
+
+    while (pos < cache->size && cache->exps[pos] < exp) {
+        pos++;
     }
-    else {
-        result.arr = realloc(result.arr, result.size * sizeof(Mono));
-        CHECK_PTR(&result.arr);
-        return result;
+
+    if (pos < cache->size && cache->exps[pos] == exp) {
+        return &cache->powers[pos];
     }
-}
 
-Poly PolyAddMonos(size_t count, const Mono monos[]) {
-    if (count == 0 || monos == NULL) {
-        return PolyZero();
+    Poly power;
+
+    if (pos == 0) {
+        power = PolyPow(cache->base, exp);
+    }
+    else {
+        power = PolyPow(cache->base, exp - cache->exps[pos - 1]);
+        PolyMulInPlace(&power, &cache->powers[pos - 1]);
     }
 
-    Mono *copy = malloc(count * sizeof(Mono));
-    CHECK_PTR(&copy);
-    for (size_t i = 0; i < count; i++) {
-        copy[i] = monos[i];
+    if (cache->size == cache->capacity) {
+        cache->capacity = cache->capacity == 0 ? 4 : 2 * cache->capacity;
+        cache->exps = realloc(cache->exps, cache->capacity * sizeof(poly_exp_t));
+        CHECK_PTR(cache->exps);
+        cache->powers = realloc(cache->powers, cache->capacity * sizeof(Poly));
+        CHECK_PTR(cache->powers);
     }
 
-    return PolyOwnMonos(count, copy);
+    memmove(&cache->exps[pos + 1], &cache->exps[pos],
+            (cache->size - pos) * sizeof(poly_exp_t));
+    memmove(&cache->powers[pos + 1], &cache->powers[pos],
+            (cache->size - pos) * sizeof(Poly));
+    cache->exps[pos] = exp;
+    cache->powers[pos] = power;
+    cache->size++;
+    return &cache->powers[pos];
 }
 
-Poly PolyCloneMonos(size_t count, const Mono monos[]) {
-    if (count == 0 || monos == NULL) {
-        return PolyZero();
+/**
+ * Zanurza wielomian @p p o zmiennych @f$x_0, x_1, \ldots@f$ w wielomian
+ * o zmiennych @f$x_{k}, x_{k+1}, \ldots@f$, gdzie @f$k@f$ to @p levels.
+ * @param[in] p : wielomian
+ * @param[in] levels : liczba dodanych poziomów
+ * @return @p p jako wielomian zmiennych od @f$x_k@f$
+ */
+static Poly PolyLift(const Poly *p, size_t levels) {
+    Poly result = PolyClone(p);
+
+    if (PolyIsCoeff(p)) {
+        return result;
     }
 
-    Mono *copy = malloc(count * sizeof(Mono));
-    CHECK_PTR(&copy);
-    for (size_t i = 0; i < count; i++) {
-        copy[i] = MonoClone(&monos[i]);
+    for (size_t i = 0; i < levels; i++) {
+        Poly wrapped = {.size = 1, .arr = malloc(sizeof(Mono))};
+        CHECK_PTR(wrapped.arr);
+        wrapped.arr[0] = (Mono) {.p = result, .exp = 0};
+        result = wrapped;
     }
 
-    return PolyOwnMonos(count, copy);
+    return result;
 }
 
 /**
- * Mnoży wielomian przez stałą.
- * @param[in] p : wielomian
- * @param[in] coeff : stała
- * @return @f$p * coeff@f$
+ * PolySubstVar dla poddrzewa @p p leżącego na głębokości @p depth.
+ * Jeśli @p relative jest prawdą, @f$q@f$ (podstawa w @p cache) nie zależy od
+ * zmiennych @f$x_0, \ldots, x_{idx-1}@f$ i jest zapisany względem poziomu
+ * @p idx, więc poziomy powyżej @p idx są przepisywane bez zmian. W przeciwnym
+ * razie wynik dla poddrzewa jest pełnym wielomianem zmiennych od @f$x_0@f$.
+ * @param[in] p : poddrzewo
+ * @param[in] depth : głębokość poddrzewa
+ * @param[in] idx : indeks podstawianej zmiennej
+ * @param[in,out] cache : potęgi @f$q@f$
+ * @param[in] relative : czy @f$q@f$ jest zapisany względem poziomu @p idx
+ * @return poddrzewo po podstawieniu
  */
-static Poly PolyMulByCoeff(const Poly *p, poly_coeff_t coeff) {
+static Poly PolySubstVarHelp(const Poly *p, size_t depth, size_t idx,
+                             PowerCache *cache, bool relative) {
     if (PolyIsCoeff(p)) {
-        return PolyFromCoeff(p->coeff * coeff);
+        return CoeffClone(p);
     }
-    else {
-        Poly q = (Poly) {.size = p->size, .arr = malloc(q.size * sizeof(Mono))};
-        CHECK_PTR(&q.arr);
-
+    else if (depth < idx && relative) {
+        PolyBuilder b = PolyBuilderInit(p->size);
         for (size_t i = 0; i < p->size; i++) {
-            Poly pom = PolyMulByCoeff(&p->arr[i].p, coeff);
-
-            if (PolyIsZero(&pom)) {
-                q.size--;
-            }
-            else {
-                q.arr[i].p = pom;
-                q.arr[i].exp = MonoGetExp(&p->arr[i]);
-            }
+            Mono m = {.p = PolySubstVarHelp(&p->arr[i].p, depth + 1, idx,
+                                            cache, relative),
+                      .exp = MonoGetExp(&p->arr[i])};
+            PolyBuilderAdd(&b, &m);
         }
+        return PolyBuilderFinish(&b);
+    }
 
-        if (q.size == 0) {
-            PolyDestroy(&q);
-            return PolyZero();
+    PolyAccumulator acc = PolyAccumulatorInit();
+
+    for (size_t i = 0; i < p->size; i++) {
+        Poly term;
+
+        if (depth < idx) {
+            term = PolySubstVarHelp(&p->arr[i].p, depth + 1, idx, cache,
+                                    relative);
+
+            if (MonoGetExp(&p->arr[i]) > 0) { // x_depth^e od zmiennej x_0
+                Mono m = {.p = PolyFromCoeff(1), .exp = MonoGetExp(&p->arr[i])};
+                Poly power = {.size = 1, .arr = &m};
+                Poly lifted = PolyLift(&power, depth);
+                PolyMulInPlace(&term, &lifted);
+                PolyDestroy(&lifted);
+            }
         }
         else {
-            q.arr = realloc(q.arr, q.size * sizeof(Mono));
-            CHECK_PTR(&q.arr);
-            return q;
+            const Poly *power = PowerCacheGet(cache, MonoGetExp(&p->arr[i]));
+            Poly lifted = PolyLift(&p->arr[i].p, relative ? 1 : idx + 1);
+            term = PolyMul(&lifted, power);
+            PolyDestroy(&lifted);
         }
+
+        PolyAccumulatorAddOwned(&acc, &term);
     }
+
+    return PolyAccumulatorFinish(&acc);
 }
 
-Poly PolyMul(const Poly *p, const Poly *q) {
-    if (PolyIsZero(p) || PolyIsZero(q)) {
-        return PolyZero();
+Poly PolySubstVar(const Poly *p, size_t idx, const Poly *q) {
+    const Poly *base = q;
+    bool relative = true;
+
+    for (size_t i = 0; i < idx && relative && !PolyIsCoeff(base); i++) {
+        if (base->size == 1 && MonoGetExp(&base->arr[0]) == 0) {
+            base = &base->arr[0].p;
+        }
+        else {
+            relative = false;
+        }
     }
-    else if (PolyIsCoeff(p) && PolyIsCoeff(q)) {
-        return PolyFromCoeff(p->coeff * q->coeff);
+
+    PowerCache cache = {.base = relative ? base : q, .exps = NULL,
+                        .powers = NULL, .size = 0, .capacity = 0};
+    Poly result = PolySubstVarHelp(p, 0, idx, &cache, relative);
+
+    for (size_t i = 0; i < cache.size; i++) {
+        PolyDestroy(&cache.powers[i]);
     }
-    else if (PolyIsCoeff(p)) {
-        return PolyMulByCoeff(q, p->coeff);
+    free(cache.exps);
+    free(cache.powers);
+    return result;
+}
+
+Poly PolyAtVar(const Poly *p, size_t idx, poly_coeff_t x) {
+    if (PolyIsCoeff(p)) {
+        return CoeffClone(p);
     }
-    else if (PolyIsCoeff(q)) {
-        return PolyMulByCoeff(p, q->coeff);
+    else if (idx == 0) {
+        return PolyAt(p, x);
     }
-    else {
-        size_t monos_size = p->size * q->size;
-        Mono monos[monos_size];
-        int index = 0;
 
-        for (size_t i = 0; i < p->size; i++) {
-            for (size_t j = 0; j < q->size; j++) {
-                monos[index] = (Mono) {.p = PolyMul(&p->arr[i].p, &q->arr[j].p),
-                       .exp = MonoGetExp(&p->arr[i]) + MonoGetExp(&q->arr[j])};
-                index++;
-            }
-        }
+    // wykładniki na tym poziomie się nie zmieniają, więc kolejność zostaje
+    PolyBuilder b = PolyBuilderInit(p->size);
 
-        return PolyAddMonos(monos_size, monos);
+    for (size_t i = 0; i < p->size; i++) {
+        Mono m = {.p = PolyAtVar(&p->arr[i].p, idx - 1, x),
+                  .exp = MonoGetExp(&p->arr[i])};
+        PolyBuilderAdd(&b, &m);
     }
-}
 
-Poly PolyNeg(const Poly *p) {
-    return PolyMulByCoeff(p, -1);
+    return PolyBuilderFinish(&b);
 }
 
-Poly PolySub(const Poly *p, const Poly *q) {
-    Poly r = PolyNeg(q);
-    Poly result = PolyAdd(p, &r);
-    PolyDestroy(&r);
-    return result;
+/**
+ * Liczba liczb pierwszych dostępnych dla PolyMulCrt, PolyPowCrt
+ * i PolyComposeCrt.
+ */
+#define CRT_PRIMES 16
+
+/** Czy typ współczynników jest węższy niż 64 bity. */
+#define COEFF_NARROW (sizeof(poly_coeff_t) < sizeof(int64_t))
+
+/** Liczba bitów, od której większa jest każda z liczb pierwszych CRT. */
+#define CRT_PRIME_BITS (COEFF_NARROW ? 29 : 61)
+
+/** Największe liczby pierwsze mniejsze od @f$2^{62}@f$. */
+static const int64_t crt_primes_wide[CRT_PRIMES] = {
+    4611686018427387847L, 4611686018427387817L, 4611686018427387787L,
+    4611686018427387761L, 4611686018427387751L, 4611686018427387737L,
+    4611686018427387733L, 4611686018427387709L, 4611686018427387701L,
+    4611686018427387631L, 4611686018427387617L, 4611686018427387587L,
+    4611686018427387461L, 4611686018427387421L, 4611686018427387409L,
+    4611686018427387329L
+};
+
+/**
+ * Największe liczby pierwsze mniejsze od @f$2^{30}@f$, dla współczynników
+ * węższych niż 64 bity.
+ */
+static const int64_t crt_primes_narrow[CRT_PRIMES] = {
+    1073741789, 1073741783, 1073741741, 1073741723, 1073741719, 1073741717,
+    1073741689, 1073741671, 1073741663, 1073741651, 1073741621, 1073741567,
+    1073741561, 1073741527, 1073741503, 1073741477
+};
+
+/**
+ * Zwraca liczbę pierwszą CRT o indeksie @p i właściwą dla typu
+ * współczynników.
+ * @param[in] i : indeks
+ * @return liczba pierwsza
+ */
+static inline int64_t CrtPrime(size_t i) {
+    return COEFF_NARROW ? crt_primes_narrow[i] : crt_primes_wide[i];
 }
 
 /**
- * Schodzi w rekurencji do interesującego nas miejsca (czyli aż @p var_idx = 0),
- * po czym szuka największego wykładnika spośród wszystkich jednomianów na tej
- * głębokości.
- * @param[in] p : wielomian
- * @param[in] var_idx : głębokość rekurencji
- * @param[in] max : maksymalny znaleziony wykładnik
- * @param[in] tmp : aktualny znaleziony wykładnik
+ * Odwrotności @f$(p_0 p_1 \cdots p_{i-1})^{-1} \bmod p_i@f$ używane przez
+ * algorytm Garnera; wyliczane przy pierwszym użyciu.
  */
-static void PolyDegByHelp(const Poly *p, size_t *var_idx, poly_exp_t *max, poly_exp_t *tmp) {
-    if (PolyIsZero(p)) {
-        *tmp = -1;
-    }
-    else if (PolyIsCoeff(p)) {
-        *tmp = 0;
-    }
-    else if (*var_idx == 0) {
-        for (size_t i = 0; i < p->size; i++) {
-            poly_exp_t exp = MonoGetExp(&p->arr[i]);
-            if (exp > *tmp) {
-                *tmp = exp;
-            }
+static uint64_t crt_inverses[CRT_PRIMES];
+
+/** Czy tablica crt_inverses jest już wyliczona. */
+static bool crt_ready = false;
+
+/** Argumenty operacji wykonywanej modulo kolejne liczby pierwsze. */
+typedef struct CrtArgs {
+    const Poly *p; ///< pierwszy argument
+    size_t k; ///< liczba wielomianów w tablicy @p q
+    const Poly *q; ///< drugi argument lub tablica argumentów złożenia
+    poly_exp_t exp; ///< wykładnik potęgi
+} CrtArgs;
+
+/** Wylicza tablicę crt_inverses z małego twierdzenia Fermata. */
+static void CrtInit(void) {
+    for (size_t i = 0; i < CRT_PRIMES; i++) {
+        uint64_t m = (uint64_t) CrtPrime(i);
+        uint64_t prod = 1;
+        for (size_t j = 0; j < i; j++) {
+            prod = MulMod(prod, (uint64_t) CrtPrime(j) % m, m);
         }
 
-        if (*tmp > *max) {
-            *max = *tmp;
-        }
-    }
-    else {
-        (*var_idx)--;
-        for (size_t i = 0; i < p->size; i++) {
-            PolyDegByHelp(&p->arr[i].p, var_idx, max, tmp);
+        uint64_t inv = 1;
+        for (uint64_t e = m - 2; e > 0; e /= 2) {
+            if (e % 2 == 1) {
+                inv = MulMod(inv, prod, m);
+            }
+            prod = MulMod(prod, prod, m);
         }
-        (*var_idx)++;
+        crt_inverses[i] = inv;
     }
+    crt_ready = true;
 }
 
-poly_exp_t PolyDegBy(const Poly *p, size_t var_idx) {
-    if (PolyIsZero(p)) {
-        return -1;
-    }
-    else if (PolyIsCoeff(p)) {
-        return 0;
-    }
-    else if (var_idx == 0) {
-        poly_exp_t max = 0;
-
-        for (size_t i = 0; i < p->size; i++) {
-            poly_exp_t exp = MonoGetExp(&p->arr[i]);
-            if (exp > max) {
-                max = exp;
-            }
+/**
+ * Odtwarza liczbę całkowitą z jej reszt modulo pierwsze @p k liczb
+ * pierwszych CRT algorytmem Garnera. Cyfry systemu mieszanego są wybierane
+ * z przedziałów symetrycznych, więc wynik jest jedynym reprezentantem
+ * o wartości bezwzględnej mniejszej od połowy iloczynu liczb pierwszych.
+ * Wynik, który nie mieści się w typie poly_coeff_t, jest liczbą wielką.
+ * @param[in] r : reszty
+ * @param[in] k : liczba reszt
+ * @return odtworzony współczynnik
+ */
+static Poly CrtReconstruct(const poly_coeff_t r[], size_t k) {
+    int64_t digits[CRT_PRIMES] = {0};
+
+    for (size_t i = 0; i < k; i++) {
+        uint64_t m = (uint64_t) CrtPrime(i);
+        poly_coeff_t ri = r[i] % CrtPrime(i);
+        uint64_t acc = 0;
+
+        for (size_t j = i; j-- > 0;) {
+            uint64_t d = digits[j] < 0 ? (uint64_t) (digits[j] + CrtPrime(i))
+                                       : (uint64_t) digits[j];
+            acc = (MulMod(acc, (uint64_t) CrtPrime(j) % m, m) + d) % m;
         }
 
-        return max;
+        uint64_t t = ri < 0 ? (uint64_t) (ri + CrtPrime(i)) : (uint64_t) ri;
+        t = MulMod((t + m - acc) % m, crt_inverses[i], m);
+        digits[i] = t > m / 2 ? (int64_t) t - (int64_t) m : (int64_t) t;
     }
 
-    poly_exp_t max = 0;
-
-    for (size_t i = 0; i < p->size; i++) {
-        poly_exp_t tmp = 0;
-        size_t var_idx_pom = var_idx - 1;
-        PolyDegByHelp(&p->arr[i].p, &var_idx_pom, &max, &tmp);
-
-        if (tmp > max) {
-            max = tmp;
+    // schemat Hornera na liczbach, dopóki wartości pośrednie się mieszczą
+    poly_coeff_t x = (poly_coeff_t) digits[k - 1];
+    size_t i = k - 1;
+    for (; i > 0; i--) {
+        poly_coeff_t y;
+        if (__builtin_mul_overflow(x, (poly_coeff_t) CrtPrime(i - 1), &y) ||
+            __builtin_add_overflow(y, (poly_coeff_t) digits[i - 1], &y)) {
+            break;
         }
+        x = y;
     }
 
-    return max;
+    Poly result = PolyFromCoeff(x);
+    for (; i-- > 0;) {
+        Poly prime = PolyFromCoeff((poly_coeff_t) CrtPrime(i));
+        Poly digit = PolyFromCoeff((poly_coeff_t) digits[i]);
+        Poly product = BigCoeffMul(&result, &prime);
+        PolyDestroy(&result);
+        result = BigCoeffAdd(&product, &digit);
+        PolyDestroy(&product);
+    }
+
+    return result;
 }
 
 /**
- * Schodzi w rekurencji najniżej jak się da aktualizując przy tym @p tmp,
- * a na końcu aktualizuje @p max jeśli znaleźliśmy większy stopień.
- * @param[in] p : wielomian
- * @param[in] max : maksymalna suma wykładników
- * @param[in] tmp : aktualna suma wykładników
+ * Łączy wyniki operacji wyliczone modulo pierwsze @p k liczb pierwszych CRT
+ * w jeden wielomian o dokładnych współczynnikach. Jednomian nieobecny
+ * w którymś z wyników ma tam współczynnik zerowy.
+ * @param[in] r : wyniki modulo kolejne liczby pierwsze
+ * @param[in] k : liczba wyników
+ * @return wielomian o współczynnikach odtworzonych z reszt
  */
-static void PolyDegHelp(const Poly *p, poly_exp_t *max, poly_exp_t *tmp) {
-    if (!PolyIsCoeff(p)) {
-        for (size_t i = 0; i < p->size; i++) {
-            *tmp += MonoGetExp(&p->arr[i]);
-
-            if (*tmp > *max) {
-                *max = *tmp;
-            }
+static Poly CrtCombine(const Poly r[], size_t k) {
+    Mono coeff_monos[CRT_PRIMES];
+    const Mono *arr[CRT_PRIMES];
+    size_t size[CRT_PRIMES];
+    size_t pos[CRT_PRIMES];
+    size_t capacity = 0;
+    bool all_coeffs = true;
+
+    for (size_t i = 0; i < k; i++) {
+        all_coeffs &= PolyIsCoeff(&r[i]);
+    }
 
-            PolyDegHelp(&p->arr[i].p, max, tmp);
-            *tmp -= MonoGetExp(&p->arr[i]);
+    if (all_coeffs) {
+        poly_coeff_t residues[CRT_PRIMES];
+        for (size_t i = 0; i < k; i++) {
+            residues[i] = (poly_coeff_t) CoeffResidue(&r[i],
+                                                      (uint64_t) CrtPrime(i));
         }
+        return CrtReconstruct(residues, k);
     }
-}
 
-poly_exp_t PolyDeg(const Poly *p) {
-    if (PolyIsZero(p)) {
-        return -1;
-    }
-    else if (PolyIsCoeff(p)) {
-        return 0;
+    for (size_t i = 0; i < k; i++) {
+        if (!PolyIsCoeff(&r[i])) {
+            arr[i] = r[i].arr;
+            size[i] = r[i].size;
+        }
+        else { // jednomian (c, 0) na stosie, bez alokacji
+            coeff_monos[i] = (Mono) {.p = r[i], .exp = 0};
+            arr[i] = &coeff_monos[i];
+            size[i] = PolyIsZero(&r[i]) ? 0 : 1;
+        }
+        pos[i] = 0;
+        capacity += size[i];
     }
-    else {
-        poly_exp_t max = 0;
 
-        for (size_t i = 0; i < p->size; i++) {
-            poly_exp_t tmp = MonoGetExp(&p->arr[i]);
-            PolyDegHelp(&p->arr[i].p, &max, &tmp);
+    Poly result = {.size = 0, .arr = malloc(capacity * sizeof(Mono))};
+    CHECK_PTR(result.arr);
 
-            if (tmp > max) {
-                max = tmp;
+    while (true) {
+        bool found = false;
+        poly_exp_t exp = 0;
+        for (size_t i = 0; i < k; i++) {
+            if (pos[i] < size[i] && (!found || arr[i][pos[i]].exp < exp)) {
+                exp = arr[i][pos[i]].exp;
+                found = true;
             }
         }
 
-        return max;
+        if (!found) {
+            break;
+        }
+
+        Poly children[CRT_PRIMES];
+        for (size_t i = 0; i < k; i++) {
+            if (pos[i] < size[i] && arr[i][pos[i]].exp == exp) {
+                children[i] = arr[i][pos[i]++].p;
+            }
+            else {
+                children[i] = PolyZero();
+            }
+        }
+
+        Poly child = CrtCombine(children, k);
+        if (!PolyIsZero(&child)) {
+            result.arr[result.size++] = (Mono) {.p = child, .exp = exp};
+        }
+    }
+
+    if (result.size == 0) {
+        free(result.arr);
+        return PolyZero();
     }
+
+    result.arr = realloc(result.arr, result.size * sizeof(Mono));
+    CHECK_PTR(result.arr);
+
+    return PolyNormalize(result);
 }
 
-bool PolyIsEq(const Poly *p, const Poly *q) {
-    Poly x = PolyToCoeff((Poly*)p);
-    Poly y = PolyToCoeff((Poly*)q);
+/**
+ * Wykonuje operację @p op modulo tyle liczb pierwszych CRT, ile wymaga
+ * ograniczenie @p bound na wartości bezwzględne współczynników wyniku,
+ * i odtwarza z reszt dokładny wynik. W trybie modularnym operacja jest
+ * wykonywana bezpośrednio, a gdy liczb pierwszych nie wystarcza, w trybie
+ * dokładnym.
+ * @param[in] op : operacja
+ * @param[in] args : argumenty operacji
+ * @param[in] bound : ograniczenie górne na wartości bezwzględne
+ * współczynników wyniku
+ * @return wynik operacji
+ */
+static Poly PolyCrt(Poly (*op)(const CrtArgs *), const CrtArgs *args,
+                    double bound) {
+    if (modulus != 0) {
+        return op(args);
+    }
 
-    if (PolyIsCoeff(&x) && PolyIsCoeff(&y))
-        return x.coeff == y.coeff;
+    // wystarczy k liczb pierwszych, gdy 2^(61k) > 4 * bound
+    size_t k = 1;
+    for (double b = 4 * bound;
+         k <= CRT_PRIMES && !(b < (double) (UINT64_C(1) << CRT_PRIME_BITS));
+         b /= (double) (UINT64_C(1) << CRT_PRIME_BITS)) {
+        k++;
+    }
 
-    if (PolyIsCoeff(&x) || PolyIsCoeff(&y))
-        return false;
+    if (k > CRT_PRIMES) {
+        bool exact = exact_coeffs;
+        exact_coeffs = true;
+        Poly result = op(args);
+        exact_coeffs = exact;
+        return result;
+    }
 
-    if (x.size != y.size)
-        return false;
+    if (!crt_ready) {
+        CrtInit();
+    }
 
-    for (size_t i = 0; i < x.size; i++) {
-        if (MonoGetExp(&x.arr[i]) != MonoGetExp(&y.arr[i]))
-            return false;
+    Poly r[CRT_PRIMES];
+    for (size_t i = 0; i < k; i++) {
+        PolySetModulus(CrtPrime(i));
+        r[i] = op(args);
+    }
+    PolySetModulus(0);
 
-        if (!PolyIsEq(&x.arr[i].p, &y.arr[i].p))
-            return false;
+    Poly result = CrtCombine(r, k);
+    for (size_t i = 0; i < k; i++) {
+        PolyDestroy(&r[i]);
     }
 
-    return true;
+    return result;
 }
 
 /**
- * Podnosi stałą @p x do potęgi @p exp.
- * @param[in] x : stała
- * @param[in] exp : wykładnik
- * @return @f$x^{exp}@f$
+ * Wylicza sumę wartości bezwzględnych współczynników wielomianu.
+ * @param[in] p : wielomian
+ * @return norma @f$L_1@f$ wielomianu @p p
  */
-static poly_coeff_t Power(poly_coeff_t x, poly_exp_t exp) {
-    if (exp == 0) {
-        return 1;
-    }
-    else if (exp % 2 == 0) {
-        poly_coeff_t y = Power(x, exp / 2);
-        return y * y;
+static double PolyNormL1(const Poly *p) {
+    if (PolyIsCoeff(p)) {
+        return CoeffMagnitude(p);
     }
-    else {
-        poly_coeff_t y = Power(x, exp - 1);
-        return x * y;
+
+    double result = 0;
+    for (size_t i = 0; i < p->size; i++) {
+        result += PolyNormL1(&p->arr[i].p);
     }
+
+    return result;
 }
 
 /**
- * Sumuje listę wielomianów.
- * @param[in] count : liczba wielomianów
- * @param[in] polys : tablica wielomianów
- * @return wielomian będący sumą wielomianów
+ * Podnosi liczbę zmiennoprzecinkową do potęgi.
+ * @param[in] x : podstawa
+ * @param[in] exp : wykładnik
+ * @return @f$x^{exp}@f$
  */
-static Poly PolyAddPolys(size_t count, Poly polys[]) {
-    Poly result = PolyZero();
+static double PowerDouble(double x, poly_exp_t exp) {
+    double result = 1;
 
-    for (size_t i = 0; i < count; i++) {
-        Poly pom = PolyAdd(&result, &polys[i]);
-        PolyDestroy(&result);
-        PolyDestroy(&polys[i]);
-        result = pom;
+    while (exp > 0) {
+        if (exp % 2 == 1) {
+            result *= x;
+        }
+        x *= x;
+        exp /= 2;
     }
 
-    free(polys);
-
     return result;
 }
 
-Poly PolyAt(const Poly *p, poly_coeff_t x) {
+/**
+ * Wylicza ograniczenie górne na normę @f$L_1@f$ złożenia wielomianu @p p
+ * z wielomianami o normach @p norms, poczynając od zmiennej @p var_idx.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba norm
+ * @param[in] norms : normy @f$L_1@f$ wielomianów podstawianych za zmienne
+ * @param[in] var_idx : indeks zmiennej
+ * @return ograniczenie górne na normę złożenia
+ */
+static double ComposeBound(const Poly *p, size_t k, const double norms[],
+                           size_t var_idx) {
     if (PolyIsCoeff(p)) {
-        return PolyFromCoeff(p->coeff);
+        return PolyNormL1(p);
     }
 
-    Poly *polys = malloc(p->size * sizeof(Poly));
-    CHECK_PTR(polys);
-
+    double result = 0;
     for (size_t i = 0; i < p->size; i++) {
-        Mono tmp = p->arr[i];
-        if (PolyIsCoeff(&p->arr[i].p)) {
-            polys[i] = PolyFromCoeff(tmp.p.coeff * Power(x, tmp.exp));
-        }
-        else {
-            polys[i] = PolyMulByCoeff(&tmp.p, Power(x, tmp.exp));
-        }
+        double norm = var_idx < k ? norms[var_idx] : 0;
+        result += ComposeBound(&p->arr[i].p, k, norms, var_idx + 1) *
+                  PowerDouble(norm, MonoGetExp(&p->arr[i]));
     }
 
-    return PolyAddPolys(p->size, polys);
+    return result;
 }
 
 /**
- * Podnosi wielomian @p p do potęgi @p exp.
- * @param[in] p : wielomian
- * @param[in] exp : wykładnik
- * @return @f$p^{exp}@f$
+ * Mnoży wielomiany z argumentów.
+ * @param[in] args : argumenty
+ * @return @f$p \cdot q@f$
  */
-static Poly PolyPower(const Poly *p, poly_exp_t exp) {
-    if (exp == 0) {
-        return PolyFromCoeff(1);
-    }
-    else if (exp % 2 == 0) {
-        Poly q = PolyPower(p, exp / 2);
-        Poly result = PolyMul(&q, &q);
-        PolyDestroy(&q);
-        return result;
-    }
-    else {
-        Poly q = PolyPower(p, exp - 1);
-        Poly result = PolyMul(p, &q);
-        PolyDestroy(&q);
-        return result;
-    }
+static Poly CrtMulOp(const CrtArgs *args) {
+    return PolyMul(args->p, args->q);
 }
 
 /**
- * PolyCompose z dodatkowym argumentem określającym, który wielomian z tablicy
- * aktualnie wstawiamy.
- * @param[in] p : wielomian
- * @param[in] k : liczba wielomianów
- * @param[in] idx : numer wielomianu z tablicy, który podstawiamy do @p p
- * @param[in] q : tablica wielomianów
- * @return @f$p(q_0, q_1, q_2, \ldots)@f$
+ * Podnosi wielomian z argumentów do potęgi.
+ * @param[in] args : argumenty
+ * @return @f$p^{exp}@f$
  */
-static Poly PolyComposeHelp(const Poly *p, size_t k, size_t idx, const Poly q[]) {
-    if (PolyIsCoeff(p)) {
-        return PolyFromCoeff(p->coeff);
-    }
-    else {
-        Poly *polys = malloc(p->size * sizeof(Poly));
-        CHECK_PTR(polys);
-        Poly arg_first;
-        Poly arg_second;
+static Poly CrtPowOp(const CrtArgs *args) {
+    return PolyPow(args->p, args->exp);
+}
 
-        for (size_t i = 0; i < p->size; i++) {
-            arg_first = PolyComposeHelp(&p->arr[i].p, k, idx + 1, q);
+/**
+ * Składa wielomiany z argumentów.
+ * @param[in] args : argumenty
+ * @return @f$p(q_0, q_1, \ldots, q_{k-1})@f$
+ */
+static Poly CrtComposeOp(const CrtArgs *args) {
+    return PolyCompose(args->p, args->k, args->q);
+}
 
-            if (idx < k) {
-                arg_second = PolyPower(&q[idx], p->arr[i].exp);
-            }
-            else if (MonoGetExp(&p->arr[i]) == 0) {
-                arg_second = PolyFromCoeff(1);
-            }
-            else {
-                arg_second = PolyZero();
-            }
+Poly PolyMulCrt(const Poly *p, const Poly *q) {
+    CrtArgs args = {.p = p, .k = 1, .q = q};
+    return PolyCrt(CrtMulOp, &args, PolyNormL1(p) * PolyNormL1(q));
+}
 
-            polys[i] = PolyMul(&arg_first, &arg_second);
-            PolyDestroy(&arg_first);
-            PolyDestroy(&arg_second);
-        }
+Poly PolyPowCrt(const Poly *p, poly_exp_t exp) {
+    CrtArgs args = {.p = p, .exp = exp};
+    return PolyCrt(CrtPowOp, &args, PowerDouble(PolyNormL1(p), exp));
+}
 
-        return PolyAddPolys(p->size, polys);
+Poly PolyComposeCrt(const Poly *p, size_t k, const Poly q[]) {
+    double *norms = malloc(k * sizeof(double));
+    CHECK_PTR(norms);
+    for (size_t i = 0; i < k; i++) {
+        norms[i] = PolyNormL1(&q[i]);
     }
-}
 
-Poly PolyCompose(const Poly *p, size_t k, const Poly q[]) {
-    return PolyComposeHelp(p, k, 0, q);
-}
\ No newline at end of file
+    CrtArgs args = {.p = p, .k = k, .q = q};
+    Poly result = PolyCrt(CrtComposeOp, &args, ComposeBound(p, k, norms, 0));
+    free(norms);
+
+    return result;
+}
@@ -12,6 +12,7 @@
 #include <assert.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 #define CHECK_PTR(p)      \
@@ -21,11 +22,96 @@
         }                 \
     } while (0)
 
+#ifndef POLY_COEFF_TYPE
+/**
+ * Typ współczynników. Można go zmienić przy kompilacji biblioteki, np. na
+ * int32_t lub __int128.
+ */
+#define POLY_COEFF_TYPE long
+#endif
+
+#ifndef POLY_EXP_TYPE
+/**
+ * Typ wykładników. Można go zmienić przy kompilacji biblioteki, np. na
+ * int16_t.
+ */
+#define POLY_EXP_TYPE int
+#endif
+
+#ifdef POLY_SUFFIX
+/** Skleja nazwę funkcji z przyrostkiem @p suffix. */
+#define POLY_CONCAT(name, suffix) name ## suffix
+/** Dokleja do nazwy funkcji przyrostek wariantu biblioteki. */
+#define POLY_EXPAND(name, suffix) POLY_CONCAT(name, suffix)
+/**
+ * Nazwa funkcji w wariancie biblioteki. Warianty o różnych typach
+ * współczynników i wykładników różnią się przyrostkiem POLY_SUFFIX, więc
+ * można je dołączyć do jednego programu.
+ */
+#define POLY_NAME(name) POLY_EXPAND(name, POLY_SUFFIX)
+
+#define PolyIsDeepCoeff   POLY_NAME(PolyIsDeepCoeff)
+#define PolyGetDeepCoeff  POLY_NAME(PolyGetDeepCoeff)
+#define PolyDestroy       POLY_NAME(PolyDestroy)
+#define PolyClone         POLY_NAME(PolyClone)
+#define PolyAdd           POLY_NAME(PolyAdd)
+#define PolyOwnMonos      POLY_NAME(PolyOwnMonos)
+#define PolyAddMonos      POLY_NAME(PolyAddMonos)
+#define PolyCloneMonos    POLY_NAME(PolyCloneMonos)
+#define PolyBuilderInit   POLY_NAME(PolyBuilderInit)
+#define PolyBuilderAdd    POLY_NAME(PolyBuilderAdd)
+#define PolyBuilderFinish POLY_NAME(PolyBuilderFinish)
+#define PolyAccumulatorInit          POLY_NAME(PolyAccumulatorInit)
+#define PolyAccumulatorAdd           POLY_NAME(PolyAccumulatorAdd)
+#define PolyAccumulatorAddOwned      POLY_NAME(PolyAccumulatorAddOwned)
+#define PolyAccumulatorAddScaledMono POLY_NAME(PolyAccumulatorAddScaledMono)
+#define PolyAccumulatorFinish        POLY_NAME(PolyAccumulatorFinish)
+#define PolyMul           POLY_NAME(PolyMul)
+#define PolyNeg           POLY_NAME(PolyNeg)
+#define PolyNegInPlace    POLY_NAME(PolyNegInPlace)
+#define PolyScaleInPlace  POLY_NAME(PolyScaleInPlace)
+#define PolyMulInPlace    POLY_NAME(PolyMulInPlace)
+#define PolyFma           POLY_NAME(PolyFma)
+#define PolyFmaAssign     POLY_NAME(PolyFmaAssign)
+#define PolySqr           POLY_NAME(PolySqr)
+#define PolyPow           POLY_NAME(PolyPow)
+#define PolyMulTrunc      POLY_NAME(PolyMulTrunc)
+#define PolyPowTrunc      POLY_NAME(PolyPowTrunc)
+#define PolySub           POLY_NAME(PolySub)
+#define PolyDegBy         POLY_NAME(PolyDegBy)
+#define PolyDeg           POLY_NAME(PolyDeg)
+#define PolyDegVector     POLY_NAME(PolyDegVector)
+#define PolyIsEq          POLY_NAME(PolyIsEq)
+#define PolyIsEqProbable  POLY_NAME(PolyIsEqProbable)
+#define PolyHash          POLY_NAME(PolyHash)
+#define PolyHashAdd       POLY_NAME(PolyHashAdd)
+#define PolyHashNeg       POLY_NAME(PolyHashNeg)
+#define PolyHashMul       POLY_NAME(PolyHashMul)
+#define PolyAt            POLY_NAME(PolyAt)
+#define PolyCompose       POLY_NAME(PolyCompose)
+#define PolyComposeTrunc  POLY_NAME(PolyComposeTrunc)
+#define PolyShift         POLY_NAME(PolyShift)
+#define PolySubstVar      POLY_NAME(PolySubstVar)
+#define PolyAtVar         POLY_NAME(PolyAtVar)
+#define PolyCoeffOverflow POLY_NAME(PolyCoeffOverflow)
+#define PolySetExact      POLY_NAME(PolySetExact)
+#define PolyGetExact      POLY_NAME(PolyGetExact)
+#define PolyCoeffFromString POLY_NAME(PolyCoeffFromString)
+#define PolyCoeffToString POLY_NAME(PolyCoeffToString)
+#define PolyIsPrime       POLY_NAME(PolyIsPrime)
+#define PolySetModulus    POLY_NAME(PolySetModulus)
+#define PolyGetModulus    POLY_NAME(PolyGetModulus)
+#define PolyReduce        POLY_NAME(PolyReduce)
+#define PolyMulCrt        POLY_NAME(PolyMulCrt)
+#define PolyPowCrt        POLY_NAME(PolyPowCrt)
+#define PolyComposeCrt    POLY_NAME(PolyComposeCrt)
+#endif
+
 /** To jest typ reprezentujący współczynniki. */
-typedef long poly_coeff_t;
+typedef POLY_COEFF_TYPE poly_coeff_t;
 
 /** To jest typ reprezentujący wykładniki. */
-typedef int poly_exp_t;
+typedef POLY_EXP_TYPE poly_exp_t;
 
 struct Mono;
 
@@ -33,13 +119,20 @@ struct Mono;
  * To jest struktura przechowująca wielomian.
  * Wielomian jest albo liczbą całkowitą, czyli wielomianem stałym
  * (wtedy `arr == NULL`), albo niepustą listą jednomianów (wtedy `arr != NULL`).
+ * W trybie dokładnym (PolySetExact) współczynnik, który nie mieści się
+ * w typie poly_coeff_t, jest liczbą wielką: wtedy `size == 0`, a `arr`
+ * wskazuje na jej cyfry.
+ * Wielomiany tworzone przez funkcje biblioteki są znormalizowane: wielomian
+ * stały jest zawsze współczynnikiem, a nie listą postaci @f$(c, 0)@f$.
  */
 typedef struct Poly {
   /**
   * To jest unia przechowująca współczynnik wielomianu lub
   * liczbę jednomianów w wielomianie.
   * Jeżeli `arr == NULL`, wtedy jest to współczynnik będący liczbą całkowitą.
-  * W przeciwnym przypadku jest to niepusta lista jednomianów.
+  * Jeżeli `arr != NULL` i `size == 0`, wielomian jest liczbą wielką,
+  * a `arr` wskazuje na jej cyfry. W przeciwnym przypadku jest to niepusta
+  * lista `size` jednomianów.
   */
   union {
     poly_coeff_t coeff; ///< współczynnik
@@ -102,22 +195,39 @@ static inline Mono MonoFromPoly(const Poly *p, poly_exp_t n) {
 
 /**
  * Sprawdza, czy wielomian jest współczynnikiem (czy jest to wielomian stały).
+ * Współczynnik może być liczbą wielką, której wartości nie ma w polu `coeff`
+ * (czyta się tam 0), więc przed odczytaniem `coeff` należy sprawdzić
+ * PolyIsBigCoeff.
  * @param[in] p : wielomian
  * @return Czy wielomian jest współczynnikiem?
  */
 static inline bool PolyIsCoeff(const Poly *p) {
-  return p->arr == NULL;
+  return p->arr == NULL || p->size == 0;
+}
+
+/**
+ * Sprawdza, czy wielomian jest współczynnikiem niemieszczącym się w typie
+ * poly_coeff_t (liczbą wielką).
+ * @param[in] p : wielomian
+ * @return Czy wielomian jest liczbą wielką?
+ */
+static inline bool PolyIsBigCoeff(const Poly *p) {
+  return p->arr != NULL && p->size == 0;
 }
 
 /**
  * Sprawdza czy wielomian jest zagłębionym współczynnikiem.
+ * Dla wielomianów utworzonych przez funkcje biblioteki jest to równoważne
+ * PolyIsCoeff.
  * @param[in] p : wielomian
  * @return Czy wielomian jest zagłębionym współczynnikiem?
  */
 bool PolyIsDeepCoeff(Poly *p);
 
 /**
- * Daje wartość zagłębionego współczynnika wielomianu.
+ * Daje wartość zagłębionego współczynnika wielomianu. Liczba wielka jest
+ * brana modulo @f$2^{w}@f$, gdzie @f$w@f$ jest liczbą bitów typu
+ * poly_coeff_t.
  * @param[in] p : wielomian
  * @return wartość zagłębionego współczynnika wielomianu
  */
@@ -129,7 +239,7 @@ poly_coeff_t PolyGetDeepCoeff(Poly *p);
  * @return Czy wielomian jest równy zeru?
  */
 static inline bool PolyIsZero(const Poly *p) {
-  return PolyIsCoeff(p) && p->coeff == 0;
+  return p->arr == NULL && p->coeff == 0;
 }
 
 /**
@@ -202,6 +312,96 @@ Poly PolyAddMonos(size_t count, const Mono monos[]);
  */
 Poly PolyCloneMonos(size_t count, const Mono monos[]);
 
+/**
+ * To jest struktura budująca wielomian z kolejno dodawanych jednomianów.
+ * Jednomiany podane w kolejności niemalejących wykładników są scalane na
+ * bieżąco i nie wymagają sortowania; w przeciwnym razie są sortowane
+ * i scalane przez PolyBuilderFinish.
+ */
+typedef struct PolyBuilder {
+  Mono *arr; ///< tablica jednomianów
+  size_t size; ///< liczba jednomianów w tablicy
+  size_t capacity; ///< rozmiar tablicy
+  bool sorted; ///< czy wykładniki jednomianów są dotąd niemalejące
+} PolyBuilder;
+
+/**
+ * Tworzy pusty budowniczy wielomianu.
+ * @param[in] capacity : przewidywana liczba jednomianów
+ * @return budowniczy
+ */
+PolyBuilder PolyBuilderInit(size_t capacity);
+
+/**
+ * Dodaje jednomian do budowanego wielomianu, przejmując na własność jego
+ * zawartość. Jednomiany zerowe są od razu usuwane.
+ * @param[in,out] b : budowniczy
+ * @param[in] m : jednomian
+ */
+void PolyBuilderAdd(PolyBuilder *b, Mono *m);
+
+/**
+ * Kończy budowanie i zwraca sumę dodanych jednomianów. Budowniczy staje się
+ * pusty i można go użyć ponownie.
+ * @param[in,out] b : budowniczy
+ * @return wielomian będący sumą jednomianów
+ */
+Poly PolyBuilderFinish(PolyBuilder *b);
+
+/** Liczba kubełków akumulatora PolyAccumulator. */
+#define POLY_ACC_LEVELS 32
+
+/**
+ * To jest struktura sumująca wiele wielomianów metodą kubełków
+ * geometrycznych (geobuckets). Kubełek @f$i@f$ przechowuje wielomian o co
+ * najwyżej @f$4^i@f$ jednomianach; dodawany wielomian trafia do najniższego
+ * kubełka, w którym się mieści, a przepełniony kubełek jest przenoszony
+ * wyżej. Suma @f$n@f$ wielomianów kosztuje więc @f$O(N \log n)@f$
+ * zamiast @f$O(N n)@f$ operacji kolejnych PolyAdd.
+ */
+typedef struct PolyAccumulator {
+  Poly buckets[POLY_ACC_LEVELS]; ///< kubełki
+} PolyAccumulator;
+
+/**
+ * Tworzy pusty akumulator.
+ * @return akumulator o sumie zero
+ */
+PolyAccumulator PolyAccumulatorInit(void);
+
+/**
+ * Dodaje do akumulatora kopię wielomianu.
+ * @param[in,out] acc : akumulator
+ * @param[in] p : wielomian
+ */
+void PolyAccumulatorAdd(PolyAccumulator *acc, const Poly *p);
+
+/**
+ * Dodaje do akumulatora wielomian, przejmując go na własność. Po wywołaniu
+ * @p p jest wielomianem zerowym.
+ * @param[in,out] acc : akumulator
+ * @param[in,out] p : wielomian
+ */
+void PolyAccumulatorAddOwned(PolyAccumulator *acc, Poly *p);
+
+/**
+ * Dodaje do akumulatora wielomian @f$c \cdot p \cdot x_0^{exp}@f$.
+ * @param[in,out] acc : akumulator
+ * @param[in] p : wielomian
+ * @param[in] coeff : stała @f$c@f$
+ * @param[in] exp : wykładnik
+ */
+void PolyAccumulatorAddScaledMono(PolyAccumulator *acc, const Poly *p,
+                                  poly_coeff_t coeff, poly_exp_t exp);
+
+/**
+ * Kończy sumowanie i zwraca sumę dodanych wielomianów. Akumulator staje się
+ * pusty i można go użyć ponownie.
+ * @param[in,out] acc : akumulator
+ * @return suma wielomianów
+ */
+Poly PolyAccumulatorFinish(PolyAccumulator *acc);
+
 /**
  * Mnoży dwa wielomiany.
  * @param[in] p : wielomian @f$p@f$
@@ -217,6 +417,88 @@ Poly PolyMul(const Poly *p, const Poly *q);
  */
 Poly PolyNeg(const Poly *p);
 
+/**
+ * Zmienia znak wielomianu w miejscu, bez alokowania nowego drzewa.
+ * @param[in,out] p : wielomian
+ */
+void PolyNegInPlace(Poly *p);
+
+/**
+ * Mnoży wielomian w miejscu przez stałą, usuwając jednomiany, które stały
+ * się zerowe.
+ * @param[in,out] p : wielomian
+ * @param[in] coeff : stała
+ */
+void PolyScaleInPlace(Poly *p, poly_coeff_t coeff);
+
+/**
+ * Mnoży wielomian @p p w miejscu przez wielomian @p q. Jeśli @p q jest
+ * postaci @f$c x_0^k@f$, wykładniki @p p są przesuwane, a współczynniki
+ * skalowane bez budowania nowego drzewa.
+ * @param[in,out] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ */
+void PolyMulInPlace(Poly *p, const Poly *q);
+
+/**
+ * Wylicza @f$p \cdot q + r@f$ bez budowania osobno iloczynu: jego kolejne
+ * wiersze są od razu dodawane do sumy.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] r : wielomian @f$r@f$
+ * @return @f$p \cdot q + r@f$
+ */
+Poly PolyFma(const Poly *p, const Poly *q, const Poly *r);
+
+/**
+ * Dodaje w miejscu iloczyn @f$p \cdot q@f$ do wielomianu @p r, tak jak
+ * PolyFma. Wielomian @p r może być jednym z czynników.
+ * @param[in,out] r : wielomian @f$r@f$
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ */
+void PolyFmaAssign(Poly *r, const Poly *p, const Poly *q);
+
+/**
+ * Podnosi wielomian do kwadratu. Korzysta z symetrii iloczynu: każdy
+ * iloczyn @f$p_i p_j@f$ dla @f$i < j@f$ liczony jest raz i podwajany,
+ * także rekurencyjnie we współczynnikach.
+ * @param[in] p : wielomian
+ * @return @f$p^2@f$
+ */
+Poly PolySqr(const Poly *p);
+
+/**
+ * Podnosi wielomian do potęgi. Dwuwyrazowe wielomiany potęgowane są ze wzoru
+ * dwumianowego, gęste liście rekurencją Millera w czasie proporcjonalnym do
+ * rozmiaru wyniku, a pozostałe przez podnoszenie do kwadratu.
+ * @param[in] p : wielomian
+ * @param[in] exp : wykładnik
+ * @return @f$p^{exp}@f$
+ */
+Poly PolyPow(const Poly *p, poly_exp_t exp);
+
+/**
+ * Mnoży dwa wielomiany, pomijając jednomiany wyniku o stopniu łącznym
+ * większym niż @p deg. Iloczyny, które nie mogą dać jednomianu dość małego
+ * stopnia, nie są w ogóle liczone, także w zagnieżdżonych współczynnikach.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] deg : największy zachowany stopień łączny
+ * @return @f$p * q@f$ obcięty do stopnia @p deg
+ */
+Poly PolyMulTrunc(const Poly *p, const Poly *q, poly_exp_t deg);
+
+/**
+ * Podnosi wielomian do potęgi, pomijając jednomiany o stopniu łącznym
+ * większym niż @p deg, także w wynikach pośrednich.
+ * @param[in] p : wielomian
+ * @param[in] exp : wykładnik
+ * @param[in] deg : największy zachowany stopień łączny
+ * @return @f$p^{exp}@f$ obcięty do stopnia @p deg
+ */
+Poly PolyPowTrunc(const Poly *p, poly_exp_t exp, poly_exp_t deg);
+
 /**
  * Odejmuje wielomian od wielomianu.
  * @param[in] p : wielomian @f$p@f$
@@ -245,13 +527,83 @@ poly_exp_t PolyDegBy(const Poly *p, size_t var_idx);
 poly_exp_t PolyDeg(const Poly *p);
 
 /**
- * Sprawdza równość dwóch wielomianów.
+ * Wylicza w jednym przejściu wielomianu jego stopnie ze względu na kolejne
+ * zmienne, stopień całkowity i liczbę zmiennych. Liczbą zmiennych jest
+ * @f$n = i + 1@f$, gdzie @f$x_i@f$ jest zmienną o największym indeksie,
+ * od której wielomian zależy (0 dla wielomianu stałego).
+ * Na pozycję @p i tablicy @p out, dla @f$i < k@f$, wpisuje stopień wielomianu
+ * ze względu na zmienną @f$x_i@f$, taki jak zwraca PolyDegBy.
+ * @param[in] p : wielomian
+ * @param[out] out : tablica stopni ze względu na kolejne zmienne
+ * @param[in] k : rozmiar tablicy @p out
+ * @param[out] deg : stopień wielomianu, jak w PolyDeg (może być NULL)
+ * @return liczba zmiennych @f$n@f$
+ */
+size_t PolyDegVector(const Poly *p, poly_exp_t out[], size_t k,
+                     poly_exp_t *deg);
+
+/**
+ * Sprawdza równość dwóch wielomianów. Zagłębiony współczynnik
+ * @f$(c, 0)@f$ zbudowany z pominięciem funkcji biblioteki jest równy
+ * współczynnikowi @f$c@f$.
  * @param[in] p : wielomian @f$p@f$
  * @param[in] q : wielomian @f$q@f$
  * @return @f$p = q@f$
  */
 bool PolyIsEq(const Poly *p, const Poly *q);
 
+/**
+ * Sprawdza z dużym prawdopodobieństwem równość dwóch wielomianów. Wylicza
+ * wartości obu wielomianów w @p rounds losowych punktach modulo liczba
+ * pierwsza @f$P = 2^{61} - 1@f$ (lemat Schwartza-Zippela), przechodząc
+ * każdy wielomian raz na punkt. Wynik `false` jest zawsze poprawny.
+ * Wynik `true` dla różnych wielomianów stopnia @f$d@f$ zdarza się
+ * z prawdopodobieństwem co najwyżej @f$(d / P)^{rounds}@f$. Postać
+ * wielomianu jest jednoznaczna, więc dwa gotowe wielomiany szybciej
+ * porównuje PolyIsEq.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @param[in] rounds : liczba losowanych punktów
+ * @return Czy z dużym prawdopodobieństwem @f$p = q@f$?
+ */
+bool PolyIsEqProbable(const Poly *p, const Poly *q, unsigned rounds);
+
+/**
+ * Wylicza skrót wielomianu. Skrót jest wartością wielomianu w ustalonym
+ * pseudolosowym punkcie modulo @f$P = 2^{61} - 1@f$, więc równe wielomiany
+ * mają równe skróty, a różne wielomiany stopnia @f$d@f$ mają równe skróty
+ * z prawdopodobieństwem co najwyżej @f$d / P@f$. Skróty wyników dodawania,
+ * odejmowania i mnożenia można wyliczyć bez przechodzenia wielomianów za
+ * pomocą PolyHashAdd, PolyHashNeg i PolyHashMul, o ile współczynniki wyniku
+ * nie przekroczyły zakresu typu poly_coeff_t.
+ * @param[in] p : wielomian
+ * @return skrót wielomianu @p p
+ */
+uint64_t PolyHash(const Poly *p);
+
+/**
+ * Wylicza skrót sumy wielomianów ze skrótów składników.
+ * @param[in] hp : skrót wielomianu @f$p@f$
+ * @param[in] hq : skrót wielomianu @f$q@f$
+ * @return skrót wielomianu @f$p + q@f$
+ */
+uint64_t PolyHashAdd(uint64_t hp, uint64_t hq);
+
+/**
+ * Wylicza skrót wielomianu przeciwnego.
+ * @param[in] hp : skrót wielomianu @f$p@f$
+ * @return skrót wielomianu @f$-p@f$
+ */
+uint64_t PolyHashNeg(uint64_t hp);
+
+/**
+ * Wylicza skrót iloczynu wielomianów ze skrótów czynników.
+ * @param[in] hp : skrót wielomianu @f$p@f$
+ * @param[in] hq : skrót wielomianu @f$q@f$
+ * @return skrót wielomianu @f$p * q@f$
+ */
+uint64_t PolyHashMul(uint64_t hp, uint64_t hq);
+
 /**
  * Wylicza wartość wielomianu w punkcie @p x.
  * Wstawia pod pierwszą zmienną wielomianu wartość @p x.
@@ -274,4 +626,177 @@ Poly PolyAt(const Poly *p, poly_coeff_t x);
  */
 Poly PolyCompose(const Poly *p, size_t k, const Poly q[]);
 
+/**
+ * Składa wielomiany, pomijając jednomiany wyniku o stopniu łącznym większym
+ * niż @p deg. Potęgi @f$q_i@f$, których najmniejszy stopień przekracza
+ * @p deg, nie są liczone.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów
+ * @param[in] q : tablica wielomianów
+ * @param[in] deg : największy zachowany stopień łączny
+ * @return @f$p(q_0, q_1, q_2, \ldots)@f$ obcięty do stopnia @p deg
+ */
+Poly PolyComposeTrunc(const Poly *p, size_t k, const Poly q[], poly_exp_t deg);
+
+/**
+ * Podstawia @f$x_i + c@f$ za zmienną @f$x_i@f$, gdzie @f$i@f$ to
+ * @p var_idx. Na poziomie zmiennej @f$x_i@f$ wykonuje przesunięcie Taylora
+ * schematem Hornera, a rzadkie wielomiany rozwija jednomian po jednomianie
+ * ze wzoru dwumianowego. Pozostałe zmienne nie są ruszane.
+ * @param[in] p : wielomian
+ * @param[in] var_idx : indeks zmiennej
+ * @param[in] c : przesunięcie
+ * @return @f$p(x_0, \ldots, x_i + c, \ldots)@f$
+ */
+Poly PolyShift(const Poly *p, size_t var_idx, poly_coeff_t c);
+
+/**
+ * Podstawia wielomian @p q za zmienną @f$x_i@f$, gdzie @f$i@f$ to @p idx.
+ * Pozostałe zmienne nie są zmieniane. Potęgi @p q liczone są raz dla całego
+ * wielomianu. Jeśli @p q nie zależy od zmiennych @f$x_0, \ldots, x_{i-1}@f$,
+ * poziomy powyżej @f$x_i@f$ są przepisywane bez mnożenia.
+ * @param[in] p : wielomian
+ * @param[in] idx : indeks zmiennej
+ * @param[in] q : podstawiany wielomian
+ * @return @f$p(x_0, \ldots, x_{i-1}, q, x_{i+1}, \ldots)@f$
+ */
+Poly PolySubstVar(const Poly *p, size_t idx, const Poly *q);
+
+/**
+ * Wylicza wartość wielomianu dla @f$x_i = x@f$, gdzie @f$i@f$ to @p idx.
+ * Zmienne o większych indeksach przesuwają się o jeden w dół, tak jak
+ * w PolyAt, które odpowiada @f$i = 0@f$. Poziomy powyżej @f$x_i@f$ są
+ * przepisywane, a na poziomie @f$x_i@f$ współczynniki są sumowane po
+ * przemnożeniu przez kolejne potęgi @f$x@f$.
+ * @param[in] p : wielomian
+ * @param[in] idx : indeks zmiennej
+ * @param[in] x : wartość zmiennej
+ * @return @f$p(x_0, \ldots, x_{i-1}, x, x_i, \ldots)@f$
+ */
+Poly PolyAtVar(const Poly *p, size_t idx, poly_coeff_t x);
+
+/**
+ * Sprawdza, czy od poprzedniego wywołania tej funkcji w którejś operacji na
+ * współczynnikach wystąpiło przepełnienie, i zeruje ten znacznik.
+ * Przepełnione współczynniki są wyliczane modulo @f$2^{64}@f$. W trybie
+ * dokładnym przepełnienia nie występują.
+ * @return Czy wystąpiło przepełnienie współczynników?
+ */
+bool PolyCoeffOverflow(void);
+
+/**
+ * Włącza lub wyłącza tryb dokładny. W trybie dokładnym współczynniki są
+ * przechowywane jako liczby typu poly_coeff_t, a dopiero wynik działania,
+ * który by się przepełnił, staje się liczbą wielką alokowaną na stercie.
+ * Liczba wielka mieszcząca się z powrotem w typie jest zamieniana na
+ * liczbę. Ustawiony moduł ma pierwszeństwo przed trybem dokładnym.
+ * @param[in] exact : czy włączyć tryb dokładny
+ */
+void PolySetExact(bool exact);
+
+/**
+ * Sprawdza, czy włączony jest tryb dokładny.
+ * @return Czy tryb dokładny jest włączony?
+ */
+bool PolyGetExact(void);
+
+/**
+ * Tworzy współczynnik z zapisu dziesiętnego dowolnej długości: opcjonalnego
+ * minusa i cyfr. Jeśli wartość nie mieści się w typie poly_coeff_t, jest
+ * liczbą wielką, niezależnie od trybu dokładnego.
+ * @param[in] str : zapis dziesiętny
+ * @param[out] end : jeśli nie jest NULL, ustawiane na pierwszy znak za
+ * liczbą, a gdy nie ma cyfr, na @p str
+ * @return współczynnik
+ */
+Poly PolyCoeffFromString(const char *str, char **end);
+
+/**
+ * Tworzy zapis dziesiętny współczynnika, także liczby wielkiej.
+ * @param[in] p : współczynnik
+ * @return napis zaalokowany na stercie, który należy zwolnić przez free
+ */
+char *PolyCoeffToString(const Poly *p);
+
+/**
+ * Wyłączne ograniczenie górne modułu arytmetyki współczynników:
+ * @f$2^{62}@f$ lub mniej dla typów współczynników węższych niż 64 bity.
+ */
+#define POLY_MAX_MODULUS \
+    ((int64_t) 1 << (sizeof(poly_coeff_t) < sizeof(int64_t) ? \
+                     8 * sizeof(poly_coeff_t) - 2 : 62))
+
+/**
+ * Sprawdza deterministycznym testem Millera-Rabina o bazach będących
+ * liczbami pierwszymi od 2 do 37, czy @p n jest liczbą pierwszą mniejszą
+ * od POLY_MAX_MODULUS.
+ * @param[in] n : liczba
+ * @return Czy @p n jest liczbą pierwszą, której można użyć jako modułu?
+ */
+bool PolyIsPrime(poly_coeff_t n);
+
+/**
+ * Ustawia moduł @p m arytmetyki współczynników. Po jego ustawieniu wszystkie
+ * działania na współczynnikach (dodawanie, mnożenie, negacja, wartość
+ * w punkcie, składanie) wykonywane są modulo @p m. Argumenty muszą mieć
+ * już współczynniki z przedziału @f$[0, m)@f$: wielomiany zbudowane przed
+ * ustawieniem modułu należy sprowadzić funkcją PolyReduce. Tylko wtedy
+ * współczynniki wyników też są resztami, bo kopie (PolyClone, jednomiany
+ * przepisywane przez PolyAdd) nie są redukowane. Moduł musi być liczbą
+ * pierwszą (w wersji debugowej sprawdza to asercja). Wartość 0 przywraca
+ * zwykłą arytmetykę.
+ * @param[in] m : moduł, 0 lub liczba pierwsza mniejsza od POLY_MAX_MODULUS
+ */
+void PolySetModulus(poly_coeff_t m);
+
+/**
+ * Zwraca ustawiony moduł arytmetyki współczynników.
+ * @return moduł lub 0, jeśli arytmetyka nie jest modularna
+ */
+poly_coeff_t PolyGetModulus(void);
+
+/**
+ * Sprowadza współczynniki wielomianu do reszt modulo ustawiony moduł,
+ * usuwając jednomiany, które stały się zerowe. Bez ustawionego modułu
+ * zwraca kopię wielomianu.
+ * @param[in] p : wielomian
+ * @return wielomian @p p o zredukowanych współczynnikach
+ */
+Poly PolyReduce(const Poly *p);
+
+/**
+ * Mnoży dwa wielomiany dokładnie. Iloczyn jest wyliczany modulo kilka liczb
+ * pierwszych bliskich @f$2^{62}@f$, a jego współczynniki odtwarzane
+ * z chińskiego twierdzenia o resztach. Liczba użytych liczb pierwszych
+ * wynika z ograniczenia @f$\|p\|_1 \cdot \|q\|_1@f$ na współczynniki
+ * iloczynu. W odróżnieniu od PolyMul wynik nigdy nie jest brany modulo
+ * @f$2^{64}@f$: współczynniki, które nie mieszczą się w typie poly_coeff_t,
+ * są liczbami wielkimi, także poza trybem dokładnym. Gdy ograniczenie
+ * przekracza iloczyn dostępnych liczb pierwszych, iloczyn jest liczony
+ * w trybie dokładnym. W trybie modularnym działa jak PolyMul.
+ * @param[in] p : wielomian @f$p@f$
+ * @param[in] q : wielomian @f$q@f$
+ * @return @f$p \cdot q@f$
+ */
+Poly PolyMulCrt(const Poly *p, const Poly *q);
+
+/**
+ * Podnosi wielomian do potęgi dokładnie, tak jak PolyMulCrt mnoży.
+ * Ograniczenie na współczynniki wyniku to @f$\|p\|_1^{exp}@f$.
+ * @param[in] p : wielomian
+ * @param[in] exp : wykładnik
+ * @return @f$p^{exp}@f$
+ */
+Poly PolyPowCrt(const Poly *p, poly_exp_t exp);
+
+/**
+ * Składa wielomiany dokładnie, tak jak PolyMulCrt mnoży. Ograniczenie na
+ * współczynniki wyniku wynika z norm @f$\|q_i\|_1@f$.
+ * @param[in] p : wielomian
+ * @param[in] k : liczba wielomianów w tablicy @p q
+ * @param[in] q : tablica wielomianów
+ * @return @f$p(q_0, q_1, \ldots, q_{k-1})@f$
+ */
+Poly PolyComposeCrt(const Poly *p, size_t k, const Poly q[]);
+
 #endif /* __POLY_H__ */
@@ -21,22 +21,23 @@ static Mono M(Poly p, poly_exp_t n) {
   return MonoFromPoly(&p, n);
 }
 
-static Poly MakePolyHelper(poly_exp_t dummy, ...) {
+static Poly MakePolyHelper(int dummy, ...) {
   va_list list;
   va_start(list, dummy);
   size_t count = 0;
   while (true) {
     va_arg(list, Poly);
-    if (va_arg(list, poly_exp_t) < 0)
+    if (va_arg(list, int) < 0)
       break;
     count++;
   }
+  va_end(list);
   va_start(list, dummy);
   Mono *arr = calloc(count, sizeof (Mono));
   CHECK_PTR(arr);
   for (size_t i = 0; i < count; ++i) {
     Poly p = va_arg(list, Poly);
-    arr[i] = MonoFromPoly(&p, va_arg(list, poly_exp_t));
+    arr[i] = MonoFromPoly(&p, (poly_exp_t) va_arg(list, int));
     assert(i == 0 || MonoGetExp(&arr[i]) > MonoGetExp(&arr[i - 1]));
   }
   va_end(list);
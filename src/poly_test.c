@@ -2844,28 +2844,31 @@ static Mono M(Poly p, poly_exp_t n) {
   return MonoFromPoly(&p, n);
 }
 
-static Poly MakePolyHelper(poly_exp_t dummy, ...) {
+// Wykładniki przechodzą przez "..." awansowane do int, także gdy poly_exp_t
+// jest węższy, więc odczytujemy je jako int.
+static Poly MakePolyHelper(int dummy, ...) {
   va_list list;
   va_start(list, dummy);
   size_t count = 0;
   while (true) {
     va_arg(list, Poly);
-    if (va_arg(list, poly_exp_t) < 0)
+    if (va_arg(list, int) < 0)
       break;
     count++;
   }
+  va_end(list);
   va_start(list, dummy);
-  Mono *arr = calloc(count, sizeof (Mono));
-  CHECK_PTR(arr);
+  PolyBuilder b = PolyBuilderInit(count);
+  poly_exp_t last_exp = -1;
   for (size_t i = 0; i < count; ++i) {
     Poly p = va_arg(list, Poly);
-    arr[i] = M(p, va_arg(list, poly_exp_t));
-    assert(i == 0 || MonoGetExp(&arr[i]) > MonoGetExp(&arr[i - 1]));
+    Mono m = M(p, (poly_exp_t) va_arg(list, int));
+    assert(MonoGetExp(&m) > last_exp);
+    last_exp = MonoGetExp(&m);
+    PolyBuilderAdd(&b, &m);
   }
   va_end(list);
-  Poly res = PolyAddMonos(count, arr);
-  free(arr);
-  return res;
+  return PolyBuilderFinish(&b);
 }
 
 #define P(...) MakePolyHelper(0, __VA_ARGS__, PolyZero(), -1)
@@ -3143,6 +3146,361 @@ static bool OverflowTest(void) {
   return res;
 }
 
+/**
+ * Sprawdza, czy przepełnienie współczynników jest wykrywane przez
+ * PolyCoeffOverflow, a wynik jest wtedy brany modulo 2^64.
+ */
+static bool CoeffOverflowTest(void) {
+  bool res = true;
+  PolyCoeffOverflow();
+  res &= TestMul(P(C(1L << 31), 1), C(1L << 31), P(C(1L << 62), 1));
+  res &= !PolyCoeffOverflow();
+  res &= TestMul(P(C(1L << 32), 1), C(1L << 32), C(0));
+  res &= PolyCoeffOverflow();
+  res &= !PolyCoeffOverflow();
+  res &= TestAdd(C(LONG_MAX), P(C(1), 0, C(1), 1), P(C(LONG_MIN), 0, C(1), 1));
+  res &= PolyCoeffOverflow();
+  res &= TestAt(P(C(1), 64), 2, C(0));
+  res &= PolyCoeffOverflow();
+  return res;
+}
+
+/**
+ * Tworzy współczynnik z zapisu dziesiętnego dowolnej długości.
+ */
+static Poly Big(const char *str) {
+  return PolyCoeffFromString(str, NULL);
+}
+
+/**
+ * Sprawdza tryb dokładny: przepełnione współczynniki stają się liczbami
+ * wielkimi, a liczby wielkie mieszczące się w typie wracają do liczb.
+ */
+static bool ExactTest(void) {
+  bool res = true;
+  PolySetExact(true);
+  PolyCoeffOverflow();
+  res &= PolyGetExact();
+  res &= TestAdd(C(LONG_MAX), P(C(1), 0, C(1), 1),
+                 P(Big("9223372036854775808"), 0, C(1), 1));
+  res &= TestMul(P(C(1L << 32), 1), C(1L << 32),
+                 P(Big("18446744073709551616"), 1));
+  res &= TestAt(P(C(1), 64), 2, Big("18446744073709551616"));
+  res &= TestMul(P(Big("-18446744073709551616"), 0, C(1), 1),
+                 P(Big("18446744073709551616"), 0, C(1), 1),
+                 P(Big("-340282366920938463463374607431768211456"), 0,
+                   C(1), 2));
+
+  Poly p = C(LONG_MIN);
+  res &= TestEq(PolyNeg(&p), Big("9223372036854775808"), true);
+  p = Big("9223372036854775808");
+  Poly one = C(1);
+  Poly q = PolySub(&p, &one);
+  res &= PolyIsBigCoeff(&p) && !PolyIsBigCoeff(&q) && q.coeff == LONG_MAX;
+  res &= TestEq(PolyClone(&p), PolyAdd(&q, &one), true);
+  res &= TestEq(PolyClone(&p), PolyClone(&q), false);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+
+  p = Big("-9223372036854775808");
+  res &= !PolyIsBigCoeff(&p) && p.coeff == LONG_MIN;
+  const char *digits = "-123456789012345678901234567890123456789";
+  p = Big(digits);
+  char *str = PolyCoeffToString(&p);
+  res &= strcmp(str, digits) == 0;
+  free(str);
+  PolyDestroy(&p);
+
+  // 2^64 = 2 mod 7
+  PolySetModulus(7);
+  p = P(Big("18446744073709551616"), 0, Big("-18446744073709551616"), 1);
+  res &= TestEq(PolyReduce(&p), P(C(2), 0, C(5), 1), true);
+  PolyDestroy(&p);
+  PolySetModulus(0);
+
+  res &= !PolyCoeffOverflow();
+  PolySetExact(false);
+  return res;
+}
+
+/**
+ * Sprawdza arytmetykę współczynników modulo liczba pierwsza ustawiona
+ * przez PolySetModulus.
+ */
+static bool ModulusTest(void) {
+  bool res = true;
+  const poly_coeff_t m = 4611686018427387847L;
+  res &= PolyIsPrime(2) && PolyIsPrime(7) && PolyIsPrime(m);
+  res &= !PolyIsPrime(0) && !PolyIsPrime(1) && !PolyIsPrime(6);
+  res &= !PolyIsPrime(3215031751L) && !PolyIsPrime(m - 2);
+  PolySetModulus(7);
+  res &= PolyGetModulus() == 7;
+  res &= TestMul(P(C(5), 0, C(3), 1), P(C(6), 0, C(4), 1),
+                 P(C(2), 0, C(3), 1, C(5), 2));
+  res &= TestAdd(P(C(3), 1), P(C(4), 1), C(0));
+  res &= TestSub(C(2), C(5), C(4));
+  res &= TestAt(P(C(2), 0, C(3), 1, C(5), 2), -1, C(4));
+  Poly p = P(C(-1), 0, C(15), 1, C(14), 2);
+  res &= TestEq(PolyReduce(&p), P(C(6), 0, C(1), 1), true);
+  PolyDestroy(&p);
+  PolySetModulus(m);
+  res &= TestMul(C(m - 2), C(m - 3), C(6));
+  res &= TestMul(C(123456789123L), C(987654321987L), C(4264714766894060568L));
+  res &= TestAdd(C(m - 1), C(-4), C(m - 5));
+  PolySetModulus(0);
+  res &= PolyGetModulus() == 0;
+  res &= TestAdd(C(3), C(4), C(7));
+  return res;
+}
+
+/**
+ * Sprawdza dokładne mnożenie i składanie wyliczane modulo kilka liczb
+ * pierwszych.
+ */
+static bool CrtTest(void) {
+  bool res = true;
+  Poly p = P(C(1L << 30), 0, C(1L << 30), 1);
+  Poly q = P(C(-(1L << 30)), 0, C(1L << 30), 1);
+  res &= TestEq(PolyMulCrt(&p, &q), P(C(-(1L << 60)), 0, C(1L << 60), 2),
+                true);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+
+  p = C(1L << 31);
+  q = C(-(1L << 32));
+  res &= TestEq(PolyMulCrt(&p, &q), C(LONG_MIN), true);
+  PolyDestroy(&q);
+  q = C(1L << 32);
+  res &= TestEq(PolyMulCrt(&p, &q), Big("9223372036854775808"), true);
+
+  p = P(C(1), 0, P(C(1L << 32), 1), 1);
+  q = P(C(-1), 0, P(C(1L << 32), 1), 1);
+  res &= TestEq(PolyMulCrt(&p, &q),
+                P(C(-1), 0, P(Big("18446744073709551616"), 2), 2), true);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+
+  p = P(C(1), 3);
+  q = P(C(1L << 20), 0, C(1), 1);
+  res &= TestEq(PolyComposeCrt(&p, 1, &q),
+                P(C(1L << 60), 0, C(3L << 40), 1, C(3L << 20), 2, C(1), 3),
+                true);
+  PolyDestroy(&q);
+  q = P(C(1L << 21), 0, C(1), 1);
+  res &= TestEq(PolyComposeCrt(&p, 1, &q),
+                P(Big("9223372036854775808"), 0, C(3L << 42), 1, C(3L << 21),
+                  2, C(1), 3),
+                true);
+  PolyDestroy(&q);
+  PolyDestroy(&p);
+
+  p = P(C(1L << 32), 0, C(1), 1);
+  res &= TestEq(PolyPowCrt(&p, 2),
+                P(Big("18446744073709551616"), 0, C(1L << 33), 1, C(1), 2),
+                true);
+  res &= TestEq(PolyPowCrt(&p, 0), C(1), true);
+  PolyDestroy(&p);
+
+  // 2^1000 przekracza iloczyn liczb pierwszych, więc liczone jest dokładnie
+  p = P(C(1), 0, C(1), 1);
+  PolySetExact(true);
+  q = PolyPow(&p, 1000);
+  PolySetExact(false);
+  res &= TestEq(PolyPowCrt(&p, 1000), q, true);
+  res &= !PolyGetExact();
+  PolyDestroy(&p);
+
+  p = P(C(3), 1);
+  q = P(C(5), 1);
+  PolySetModulus(7);
+  Poly r = PolyMulCrt(&p, &q);
+  PolySetModulus(0);
+  res &= TestEq(r, P(C(1), 2), true);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+  return res;
+}
+
+/**
+ * Sprawdza zmianę znaku i mnożenie przez stałą w miejscu.
+ */
+static bool InPlaceTest(void) {
+  bool res = true;
+  Poly p = P(P(C(1), 0, C(-2), 3), 1, C(5), 2);
+  PolyNegInPlace(&p);
+  res &= TestEq(PolyClone(&p), P(P(C(-1), 0, C(2), 3), 1, C(-5), 2), true);
+  PolyScaleInPlace(&p, 3);
+  res &= TestEq(PolyClone(&p), P(P(C(-3), 0, C(6), 3), 1, C(-15), 2), true);
+  PolyScaleInPlace(&p, 0);
+  res &= PolyIsZero(&p);
+
+  p = P(P(C(1L << 32), 0, C(1), 1), 1, C(1L << 32), 2);
+  PolyScaleInPlace(&p, 1L << 32);
+  res &= TestEq(p, P(P(C(1L << 32), 1), 1), true);
+  PolyCoeffOverflow();
+
+  p = C(7);
+  PolyNegInPlace(&p);
+  res &= TestEq(p, C(-7), true);
+
+  PolySetModulus(7);
+  p = P(C(3), 0, C(7), 1);
+  PolyNegInPlace(&p);
+  res &= TestEq(p, C(4), true);
+  PolySetModulus(0);
+  return res;
+}
+
+/**
+ * Sprawdza mnożenie przez wielomiany postaci c x_0^k, które tylko
+ * przesuwa wykładniki i skaluje współczynniki.
+ */
+static bool ScaledPowerTest(void) {
+  bool res = true;
+  res &= TestMul(P(C(1), 0, P(C(2), 1), 3), P(C(-3), 2),
+                 P(C(-3), 2, P(C(-6), 1), 5));
+  res &= TestMul(P(C(-3), 2), P(C(1), 0, C(2), 3), P(C(-3), 2, C(-6), 5));
+  res &= TestMul(P(C(1L << 32), 1, C(1), 4), P(C(1L << 32), 2),
+                 P(C(1L << 32), 6));
+  PolyCoeffOverflow();
+
+  Poly p = P(C(1), 0, P(C(2), 1), 3);
+  Poly q = P(C(5), 4);
+  PolyMulInPlace(&p, &q);
+  res &= TestEq(PolyClone(&p), P(C(5), 4, P(C(10), 1), 7), true);
+  PolyDestroy(&p);
+  p = C(3);
+  PolyMulInPlace(&p, &q);
+  res &= TestEq(PolyClone(&p), P(C(15), 4), true);
+  PolyDestroy(&q);
+  q = P(C(1), 0, C(1), 1);
+  PolyMulInPlace(&p, &q);
+  res &= TestEq(p, P(C(15), 4, C(15), 5), true);
+  PolyDestroy(&q);
+  return res;
+}
+
+/**
+ * Sprawdza PolyAddMonos na długiej, nieposortowanej liście jednomianów
+ * o powtarzających się wykładnikach, porównując wynik z kolejnymi
+ * wywołaniami PolyAdd.
+ */
+static bool ManyMonosTest(void) {
+  const size_t count = 1000;
+  Mono *monos = malloc(count * sizeof(Mono));
+  CHECK_PTR(monos);
+  Poly sum = C(0);
+  for (size_t i = 0; i < count; i++) {
+    poly_exp_t exp = (poly_exp_t) ((i * 7919) % 97 + (i % 3) * 65536);
+    Poly child = i % 2 == 0 ? C((poly_coeff_t) i - 501)
+                            : P(C((poly_coeff_t) i), (poly_exp_t) (i % 5));
+    monos[i] = M(child, exp);
+    Poly mono = P(PolyClone(&child), exp);
+    Poly tmp = PolyAdd(&sum, &mono);
+    PolyDestroy(&sum);
+    PolyDestroy(&mono);
+    sum = tmp;
+  }
+  Poly p = PolyAddMonos(count, monos);
+  free(monos);
+  return TestEq(p, sum, true);
+}
+
+/**
+ * Sprawdza budowanie wielomianów przez PolyBuilder z jednomianów
+ * posortowanych, nieposortowanych i powtarzających się.
+ */
+static bool BuilderTest(void) {
+  bool res = true;
+  PolyBuilder b = PolyBuilderInit(0);
+  Mono m[] = {M(C(1), 0), M(C(2), 1), M(C(-2), 1), {.p = C(0), .exp = 2},
+              M(P(C(1), 1), 3), M(P(C(1), 0, C(1), 1), 3)};
+  for (size_t i = 0; i < sizeof(m) / sizeof(m[0]); i++)
+    PolyBuilderAdd(&b, &m[i]);
+  res &= TestEq(PolyBuilderFinish(&b), P(C(1), 0, P(C(1), 0, C(2), 1), 3),
+                true);
+
+  Mono n[] = {M(C(5), 4), M(C(1), 2), M(C(3), 4), M(C(-1), 2)};
+  for (size_t i = 0; i < sizeof(n) / sizeof(n[0]); i++)
+    PolyBuilderAdd(&b, &n[i]);
+  res &= TestEq(PolyBuilderFinish(&b), P(C(8), 4), true);
+
+  Mono z[] = {M(C(3), 0), M(C(-3), 0)};
+  for (size_t i = 0; i < sizeof(z) / sizeof(z[0]); i++)
+    PolyBuilderAdd(&b, &z[i]);
+  res &= TestEq(PolyBuilderFinish(&b), C(0), true);
+  res &= TestEq(PolyBuilderFinish(&b), C(0), true);
+  return res;
+}
+
+/**
+ * Sprawdza sumowanie wielomianów przez PolyAccumulator, porównując wynik
+ * z kolejnymi wywołaniami PolyAdd.
+ */
+static bool AccumulatorTest(void) {
+  bool res = true;
+  PolyAccumulator acc = PolyAccumulatorInit();
+  Poly sum = C(0);
+  for (poly_coeff_t i = 0; i < 300; i++) {
+    Poly p = P(C(i - 1000), (poly_exp_t) (i % 17), P(C(1), 1, C(i + 1), 2),
+               (poly_exp_t) (17 + i % 5));
+    Poly tmp = PolyAdd(&sum, &p);
+    PolyDestroy(&sum);
+    sum = tmp;
+    if (i % 2 == 0) {
+      PolyAccumulatorAdd(&acc, &p);
+      PolyDestroy(&p);
+    }
+    else {
+      PolyAccumulatorAddOwned(&acc, &p);
+      res &= PolyIsZero(&p);
+    }
+  }
+  res &= TestEq(PolyAccumulatorFinish(&acc), sum, true);
+  res &= TestEq(PolyAccumulatorFinish(&acc), C(0), true);
+
+  Poly p = P(C(1), 0, P(C(2), 1), 1);
+  PolyAccumulatorAddScaledMono(&acc, &p, 3, 2);
+  PolyAccumulatorAddScaledMono(&acc, &p, -3, 0);
+  PolyAccumulatorAddScaledMono(&acc, &p, 0, 5);
+  Poly q = C(4);
+  PolyAccumulatorAddScaledMono(&acc, &q, 2, 3);
+  res &= TestEq(PolyAccumulatorFinish(&acc),
+                P(C(-3), 0, P(C(-6), 1), 1, C(3), 2, P(C(8), 0, C(6), 1), 3),
+                true);
+  PolyDestroy(&p);
+  return res;
+}
+
+/**
+ * Sprawdza PolyFma i PolyFmaAssign, również gdy sumowany wielomian jest
+ * jednym z czynników.
+ */
+static bool FmaTest(void) {
+  bool res = true;
+  Poly p = P(P(C(1), 0, C(1), 1), 0, C(2), 1);
+  Poly q = P(P(C(1), 0, C(-1), 1), 0, C(3), 2);
+  Poly r = P(P(C(-1), 0, C(1), 2), 0, C(5), 3);
+  Poly fma = PolyFma(&p, &q, &r);
+  Poly mul = PolyMul(&p, &q);
+  res &= TestEq(PolyClone(&fma), PolyAdd(&mul, &r), true);
+  PolyFmaAssign(&r, &p, &q);
+  res &= TestEq(fma, PolyClone(&r), true);
+  PolyDestroy(&mul);
+
+  Poly square = PolyMul(&r, &r);
+  Poly expected = PolyAdd(&square, &r);
+  PolyFmaAssign(&r, &r, &r);
+  res &= TestEq(r, expected, true);
+  PolyDestroy(&square);
+
+  Poly zero = PolyZero();
+  PolyFmaAssign(&p, &q, &zero);
+  res &= TestEq(p, P(P(C(1), 0, C(1), 1), 0, C(2), 1), true);
+  PolyDestroy(&q);
+  return res;
+}
+
 /** WŁAŚCIWE TESTY NIEUDOSTĘPNIONE W PRZYKŁADZIE **/
 
 /**
@@ -3377,21 +3735,18 @@ static bool DegTest(void) {
  * @param exp tablica wykładników
  */
 static Poly MakePoly(size_t count, const poly_coeff_t *val, poly_exp_t *exp) {
-  Mono *tmp = calloc(count, sizeof (Mono));
-  size_t shift = 0;
+  PolyBuilder b = PolyBuilderInit(count);
   for (size_t i = 0; i < count; i++) {
     Poly p = PolyFromCoeff(val[i]);
     if (val[i] == 0) {
-      shift--;
       PolyDestroy(&p);
     }
     else {
-      tmp[i + shift] = MonoFromPoly(&p, exp[i]);
+      Mono m = MonoFromPoly(&p, exp[i]);
+      PolyBuilderAdd(&b, &m);
     }
   }
-  Poly res = PolyAddMonos(count + shift, tmp);
-  free(tmp);
-  return res;
+  return PolyBuilderFinish(&b);
 }
 
 /**
@@ -3402,12 +3757,12 @@ static Poly MakePoly(size_t count, const poly_coeff_t *val, poly_exp_t *exp) {
  */
 static Poly MakePolyFromPolynomials(size_t count, const Poly *val,
                                     poly_exp_t *exp) {
-  Mono *tmp = calloc(count, sizeof (struct Mono));
-  for (size_t i = 0; i < count; ++i)
-    tmp[i] = MonoFromPoly(&val[i], exp[i]);
-  Poly res = PolyAddMonos(count, tmp);
-  free(tmp);
-  return res;
+  PolyBuilder b = PolyBuilderInit(count);
+  for (size_t i = 0; i < count; ++i) {
+    Mono m = MonoFromPoly(&val[i], exp[i]);
+    PolyBuilderAdd(&b, &m);
+  }
+  return PolyBuilderFinish(&b);
 }
 
 /**
@@ -3466,20 +3821,22 @@ static Poly RecursiveBuild2(int depth, int *exp_shift, int *coef_shift,
   else {
     size_t size = exp_arr[*exp_shift];
     *exp_shift += 1;
-    Mono m[size];
+    PolyBuilder b = PolyBuilderInit(size);
     for (size_t i = 0; i < size; ++i) {
       Poly p = RecursiveBuild2(depth - 1, exp_shift, coef_shift, coef_arr, exp_arr);
+      Mono m;
       if (PolyIsZero(&p)) {
         PolyDestroy(&p);
         Poly p2 = PolyFromCoeff(1);
-        m[i] = MonoFromPoly(&p2, exp_arr[*exp_shift]);
+        m = MonoFromPoly(&p2, exp_arr[*exp_shift]);
       }
       else {
-        m[i] = MonoFromPoly(&p, exp_arr[*exp_shift]);
+        m = MonoFromPoly(&p, exp_arr[*exp_shift]);
       }
+      PolyBuilderAdd(&b, &m);
       *exp_shift += 1;
     }
-    return PolyAddMonos(size, m);
+    return PolyBuilderFinish(&b);
   }
 }
 
@@ -3896,6 +4253,446 @@ static bool IsEqTest(void) {
   return result;
 }
 
+/**
+ * Sprawdza funkcję PolyIsEqProbable na wielomianach równych i różnych,
+ * w tym różniących się jednym głęboko zagnieżdżonym współczynnikiem.
+ */
+static bool IsEqProbableTest(void) {
+  bool result = true;
+  const size_t copy_size = 1000;
+  poly_coeff_t *coef_copy = calloc(copy_size, sizeof (poly_coeff_t));
+  memcpy(coef_copy, coef_arr1, copy_size * sizeof (poly_coeff_t));
+  coef_copy[90]++;
+  {
+    Poly p1 = BuildRecursivePoly(coef_arr1, exp_arr1, 100);
+    Poly p2 = BuildRecursivePoly(coef_arr1, exp_arr1, 100);
+    Poly p3 = BuildRecursivePoly(coef_copy, exp_arr1, 100);
+    if (!PolyIsEqProbable(&p1, &p2, 4))
+      result = false;
+    if (PolyIsEqProbable(&p1, &p3, 4))
+      result = false;
+    PolyDestroy(&p1);
+    PolyDestroy(&p2);
+    PolyDestroy(&p3);
+  }
+  {
+    // (x + y)^2 = x^2 + 2xy + y^2
+    Poly s = P(P(C(1), 1), 0, C(1), 1);
+    Poly sq = PolyMul(&s, &s);
+    Poly expected = P(P(C(1), 2), 0, P(C(2), 1), 1, C(1), 2);
+    Poly wrong = P(P(C(1), 2), 0, P(C(2), 1), 1, C(1), 3);
+    if (!PolyIsEqProbable(&sq, &expected, 4))
+      result = false;
+    if (PolyIsEqProbable(&sq, &wrong, 4))
+      result = false;
+    PolyDestroy(&s);
+    PolyDestroy(&sq);
+    PolyDestroy(&expected);
+    PolyDestroy(&wrong);
+  }
+  {
+    Poly p1 = C(-1);
+    Poly p2 = C(-1);
+    Poly p3 = C(1);
+    if (!PolyIsEqProbable(&p1, &p2, 1) || PolyIsEqProbable(&p1, &p3, 1))
+      result = false;
+  }
+  free(coef_copy);
+  return result;
+}
+
+/**
+ * Sprawdza, czy skróty wielomianów są zgodne z równością wielomianów i czy
+ * skróty wyników działań wyliczone ze skrótów argumentów są poprawne.
+ */
+static bool HashTest(void) {
+  bool result = true;
+  Poly p1 = BuildRecursivePoly(coef_arr1, exp_arr1, 100);
+  Poly p2 = BuildRecursivePoly(coef_arr2, exp_arr1, 100);
+  Poly p3 = BuildRecursivePoly(coef_arr1, exp_arr1, 100);
+  uint64_t h1 = PolyHash(&p1);
+  uint64_t h2 = PolyHash(&p2);
+  if (h1 != PolyHash(&p3) || h1 == h2)
+    result = false;
+
+  Poly sum = PolyAdd(&p1, &p2);
+  Poly prod = PolyMul(&p1, &p2);
+  Poly neg = PolyNeg(&p2);
+  Poly diff = PolySub(&p1, &p2);
+  if (PolyHash(&sum) != PolyHashAdd(h1, h2))
+    result = false;
+  if (PolyHash(&prod) != PolyHashMul(h1, h2))
+    result = false;
+  if (PolyHash(&neg) != PolyHashNeg(h2))
+    result = false;
+  if (PolyHash(&diff) != PolyHashAdd(h1, PolyHashNeg(h2)))
+    result = false;
+
+  Poly zero = PolyZero();
+  if (PolyHash(&zero) != 0 || PolyHashNeg(0) != 0)
+    result = false;
+
+  PolyDestroy(&p1);
+  PolyDestroy(&p2);
+  PolyDestroy(&p3);
+  PolyDestroy(&sum);
+  PolyDestroy(&prod);
+  PolyDestroy(&neg);
+  PolyDestroy(&diff);
+  return result;
+}
+
+/**
+ * Sprawdza, czy PolyDegVector daje te same stopnie co PolyDegBy i PolyDeg.
+ */
+static bool DegVectorTest(void) {
+  bool result = true;
+  int exp_shift = 0;
+  int coef_shift = 0;
+  const size_t depth = 5;
+  Poly p = RecursiveBuild(depth, &exp_shift, &coef_shift);
+  poly_exp_t degs[depth + 2];
+  poly_exp_t deg;
+  if (PolyDegVector(&p, degs, depth + 2, &deg) != depth)
+    result = false;
+  for (size_t i = 0; i < depth + 2; ++i)
+    if (degs[i] != PolyDegBy(&p, i))
+      result = false;
+  if (deg != PolyDeg(&p))
+    result = false;
+  PolyDestroy(&p);
+
+  p = C(0);
+  if (PolyDegVector(&p, degs, 2, &deg) != 0 || deg != -1 || degs[1] != -1)
+    result = false;
+  p = C(7);
+  if (PolyDegVector(&p, degs, 2, &deg) != 0 || deg != 0 || degs[0] != 0)
+    result = false;
+  p = P(P(C(1), 3), 0);
+  if (PolyDegVector(&p, degs, 1, NULL) != 2 || degs[0] != 0)
+    result = false;
+  PolyDestroy(&p);
+  return result;
+}
+
+/**
+ * Sprawdza, czy wyniki operacji są znormalizowane, czyli czy wielomiany stałe
+ * są zawsze współczynnikami, a nie łańcuchami jednomianów z wykładnikiem 0,
+ * oraz czy PolyIsEq rozpoznaje takie łańcuchy zbudowane ręcznie.
+ */
+static bool NormalizationTest(void) {
+  bool res = true;
+  Poly p = P(P(C(3), 0), 0);
+  res &= PolyIsCoeff(&p) && p.coeff == 3;
+  PolyDestroy(&p);
+
+  Poly a = P(C(3), 0, C(2), 1);
+  Poly b = P(C(-2), 1);
+  p = PolyAdd(&a, &b);
+  res &= PolyIsCoeff(&p) && p.coeff == 3;
+  PolyDestroy(&p);
+  p = PolySub(&a, &a);
+  res &= PolyIsZero(&p);
+  PolyDestroy(&p);
+  PolyDestroy(&a);
+  PolyDestroy(&b);
+
+  a = P(P(C(1), 0, C(1), 1), 0);
+  b = P(P(C(1), 1), 0);
+  p = PolySub(&a, &b);
+  res &= PolyIsCoeff(&p) && p.coeff == 1;
+  PolyDestroy(&p);
+  p = PolyAt(&a, 7);
+  res &= !PolyIsCoeff(&p);
+  PolyDestroy(&p);
+  PolyDestroy(&a);
+  PolyDestroy(&b);
+
+  a = P(C(1L << 32), 0, C(1L << 32), 1);
+  b = C(1L << 32);
+  p = PolyMul(&a, &b);
+  res &= PolyIsZero(&p);
+  PolyDestroy(&p);
+  PolyDestroy(&a);
+  PolyDestroy(&b);
+
+  // (3, 0) zbudowany ręcznie, z pominięciem normalizacji
+  Mono *raw = malloc(sizeof(Mono));
+  raw[0] = (Mono) {.p = C(3), .exp = 0};
+  p = (Poly) {.size = 1, .arr = raw};
+  a = C(3);
+  b = P(C(3), 1);
+  res &= PolyIsDeepCoeff(&p) && PolyGetDeepCoeff(&p) == 3;
+  res &= PolyIsEq(&p, &a) && PolyIsEq(&a, &p) && !PolyIsEq(&p, &b);
+  Poly q = P(p, 1);
+  res &= PolyIsEq(&q, &b) && PolyIsEq(&b, &q);
+  PolyDestroy(&q);
+  PolyDestroy(&a);
+  PolyDestroy(&b);
+  return res;
+}
+
+/**
+ * Sprawdza podnoszenie do kwadratu przez PolySqr, porównując wyniki
+ * z iloczynem PolyMul wielomianu przez siebie.
+ */
+static bool SqrTest(void) {
+  bool res = true;
+  Poly p = P(P(C(1), 0, C(2), 1), 0, P(C(3), 2), 1, C(4), 3);
+  res &= TestEq(PolySqr(&p), PolyMul(&p, &p), true);
+  PolyDestroy(&p);
+
+  p = P(C(-3), 1, C(5), 4, C(7), 9);
+  res &= TestEq(PolySqr(&p), PolyMul(&p, &p), true);
+  PolyDestroy(&p);
+
+  p = P(P(C(-2), 3), 5);
+  res &= TestEq(PolySqr(&p), P(P(C(4), 6), 10), true);
+  PolyDestroy(&p);
+
+  p = C(-9);
+  res &= TestEq(PolySqr(&p), C(81), true);
+
+  p = P(P(C(1), 0, P(C(-1), 1, C(2), 2), 3), 0, C(5), 2,
+        P(P(C(3), 0, C(-4), 5), 1, C(6), 2), 7);
+  res &= TestEq(PolySqr(&p), PolyMul(&p, &p), true);
+  Poly x4 = P(C(1), 4);
+  Poly r = PolyMul(&p, &p);
+  Poly s = PolyMul(&r, &r);
+  res &= TestEq(PolyCompose(&x4, 1, &p), s, true);
+  PolyDestroy(&x4);
+  PolyDestroy(&r);
+  PolyDestroy(&p);
+  return res;
+}
+
+/**
+ * Mnoży wielomian @p p przez siebie @p exp razy kolejnymi wywołaniami
+ * PolyMulInPlace.
+ * @param p wielomian
+ * @param exp wykładnik
+ * @return @f$p^{exp}@f$
+ */
+static Poly RepeatedMul(const Poly *p, poly_exp_t exp) {
+  Poly result = C(1);
+  for (poly_exp_t i = 0; i < exp; ++i)
+    PolyMulInPlace(&result, p);
+  return result;
+}
+
+/**
+ * Sprawdza potęgowanie przez PolyPow, również w trybie modularnym i dla
+ * współczynników, których potęgi mieszczą się w typie tylko na styk.
+ */
+static bool PowTest(void) {
+  bool res = true;
+  Poly p = C(-3);
+  res &= TestEq(PolyPow(&p, 5), C(-243), true);
+  res &= TestEq(PolyPow(&p, 0), C(1), true);
+
+  p = P(C(1), 0, C(1), 1);
+  res &= TestEq(PolyPow(&p, 4),
+                P(C(1), 0, C(4), 1, C(6), 2, C(4), 3, C(1), 4), true);
+  res &= TestEq(PolyPow(&p, 20), RepeatedMul(&p, 20), true);
+  PolyDestroy(&p);
+
+  p = P(P(C(1), 0, C(-1), 2), 1, P(C(2), 1), 3);
+  res &= TestEq(PolyPow(&p, 7), RepeatedMul(&p, 7), true);
+  PolyDestroy(&p);
+
+  p = P(C(2), 3, C(-1), 4, C(5), 5, C(1), 7);
+  for (poly_exp_t i = 1; i < 12; ++i)
+    res &= TestEq(PolyPow(&p, i), RepeatedMul(&p, i), true);
+  PolyDestroy(&p);
+
+  p = P(C(1), 0, C(1000000), 1, C(3), 2);
+  PolyCoeffOverflow();
+  Poly q = PolyPow(&p, 3);
+  res &= !PolyCoeffOverflow();
+  res &= TestEq(q, RepeatedMul(&p, 3), true);
+  PolyDestroy(&p);
+
+  p = P(P(C(1), 0, C(2), 1), 0, C(3), 1, P(C(-1), 2), 2);
+  res &= TestEq(PolyPow(&p, 5), RepeatedMul(&p, 5), true);
+
+  PolySetModulus(7);
+  res &= TestEq(PolyPow(&p, 6), RepeatedMul(&p, 6), true);
+  PolyDestroy(&p);
+  p = P(C(1), 0, C(1), 1);
+  res &= TestEq(PolyPow(&p, 7), P(C(1), 0, C(1), 7), true);
+  PolyDestroy(&p);
+  PolySetModulus(0);
+  return res;
+}
+
+/**
+ * Sprawdza mnożenie, potęgowanie i składanie obcinane do wyrazów stopnia
+ * co najwyżej zadanego, porównując je z pełnymi wynikami tam, gdzie
+ * obcięcie niczego nie usuwa.
+ */
+static bool TruncTest(void) {
+  bool res = true;
+  Poly p = P(C(1), 0, P(C(1), 0, C(1), 1), 1);
+  Poly q = P(P(C(2), 1), 0, C(-1), 2);
+  res &= TestEq(PolyMulTrunc(&p, &q, 2),
+                P(P(C(2), 1), 0, P(C(2), 1), 1, C(-1), 2), true);
+  res &= TestEq(PolyMulTrunc(&p, &q, 0), C(0), true);
+  res &= TestEq(PolyMulTrunc(&p, &q, -1), C(0), true);
+  res &= TestEq(PolyMulTrunc(&p, &q, 10), PolyMul(&p, &q), true);
+
+  res &= TestEq(PolyPowTrunc(&p, 5, 1), P(C(1), 0, C(5), 1), true);
+  res &= TestEq(PolyPowTrunc(&p, 0, 0), C(1), true);
+  res &= TestEq(PolyPowTrunc(&q, 2, 1), C(0), true);
+  res &= TestEq(PolyPowTrunc(&p, 3, 6), PolyPow(&p, 3), true);
+
+  Poly r = P(P(C(1), 1), 1, C(3), 2);
+  Poly args[2] = {P(C(1), 0, C(1), 1), P(C(1), 2)};
+  res &= TestEq(PolyComposeTrunc(&r, 2, args, 3),
+                P(C(3), 0, C(6), 1, C(4), 2, C(1), 3), true);
+  res &= TestEq(PolyComposeTrunc(&r, 2, args, 5),
+                PolyCompose(&r, 2, args), true);
+  res &= TestEq(PolyComposeTrunc(&r, 1, args, 1), P(C(3), 0, C(6), 1), true);
+  PolyDestroy(&args[0]);
+  PolyDestroy(&args[1]);
+  PolyDestroy(&r);
+  PolyDestroy(&p);
+  PolyDestroy(&q);
+  return res;
+}
+
+/**
+ * Sprawdza mnożenie i potęgowanie jednomianów, które tylko przesuwa
+ * wykładniki i skaluje współczynniki, także gdy w trybie modularnym iloczyn
+ * współczynników staje się zerem.
+ */
+static bool MonomialTest(void) {
+  bool res = true;
+  Poly m = P(P(C(-2), 3), 1);
+  Poly p = P(P(C(1), 0, C(1), 1), 0, C(5), 2);
+  res &= TestEq(PolyMul(&p, &m),
+                P(P(C(-2), 3, C(-2), 4), 1, P(C(-10), 3), 3), true);
+  res &= TestEq(PolyMul(&m, &p),
+                P(P(C(-2), 3, C(-2), 4), 1, P(C(-10), 3), 3), true);
+  PolyMulInPlace(&p, &m);
+  res &= TestEq(PolyClone(&p),
+                P(P(C(-2), 3, C(-2), 4), 1, P(C(-10), 3), 3), true);
+  res &= TestEq(PolyPow(&m, 3), P(P(C(-8), 9), 3), true);
+
+  Poly args[2] = {P(C(3), 2), P(P(C(1), 1), 0)};
+  Poly q = P(P(C(1), 0, C(1), 2), 1);
+  res &= TestEq(PolyCompose(&q, 2, args),
+                P(P(C(3), 0, C(3), 2), 2), true);
+  PolyDestroy(&args[0]);
+  PolyDestroy(&args[1]);
+
+  PolySetModulus(7);
+  Poly r = P(C(7), 0, C(3), 1);
+  Poly three = P(P(C(3), 1), 1);
+  res &= TestEq(PolyMul(&r, &three), P(P(C(2), 1), 2), true);
+  PolyMulInPlace(&r, &three);
+  res &= TestEq(r, P(P(C(2), 1), 2), true);
+  PolySetModulus(0);
+
+  PolyDestroy(&three);
+  PolyDestroy(&q);
+  PolyDestroy(&p);
+  PolyDestroy(&m);
+  return res;
+}
+
+/**
+ * Sprawdza przesunięcie Taylora PolyShift, porównując je ze złożeniem
+ * z wielomianem @f$x + c@f$.
+ */
+static bool ShiftTest(void) {
+  bool res = true;
+  Poly p = P(C(1), 3);
+  res &= TestEq(PolyShift(&p, 0, 2),
+                P(C(8), 0, C(12), 1, C(6), 2, C(1), 3), true);
+  res &= TestEq(PolyShift(&p, 1, 2), PolyClone(&p), true);
+  PolyDestroy(&p);
+
+  p = P(C(5), 0, P(C(1), 2), 1);
+  res &= TestEq(PolyShift(&p, 1, -1),
+                P(C(5), 0, P(C(1), 0, C(-2), 1, C(1), 2), 1), true);
+  res &= TestEq(PolyShift(&p, 0, 0), PolyClone(&p), true);
+  PolyDestroy(&p);
+
+  p = P(P(C(1), 1), 0, C(2), 20);
+  Poly args[2] = {P(C(-1), 0, C(1), 1), P(P(C(1), 1), 0)};
+  res &= TestEq(PolyShift(&p, 0, -1), PolyCompose(&p, 2, args), true);
+  PolyDestroy(&args[0]);
+  PolyDestroy(&args[1]);
+  PolyDestroy(&p);
+
+  p = C(7);
+  res &= TestEq(PolyShift(&p, 0, 3), C(7), true);
+  return res;
+}
+
+/**
+ * Sprawdza podstawianie wielomianu za jedną zmienną przez PolySubstVar,
+ * porównując je z PolyCompose.
+ */
+static bool SubstVarTest(void) {
+  bool res = true;
+  Poly p = P(C(3), 0, P(C(1), 2), 1);
+  Poly q = P(C(1), 0, C(1), 1);
+  res &= TestEq(PolySubstVar(&p, 1, &q),
+                P(C(3), 0, C(1), 1, C(2), 2, C(1), 3), true);
+  res &= TestEq(PolySubstVar(&p, 2, &q), PolyClone(&p), true);
+  PolyDestroy(&q);
+
+  q = P(P(C(2), 0, C(1), 1), 0);
+  res &= TestEq(PolySubstVar(&p, 1, &q),
+                P(C(3), 0, P(C(4), 0, C(4), 1, C(1), 2), 1), true);
+  PolyDestroy(&q);
+
+  q = C(-2);
+  res &= TestEq(PolySubstVar(&p, 0, &q), P(P(C(3), 0, C(-2), 2), 0), true);
+  PolyDestroy(&q);
+  PolyDestroy(&p);
+
+  p = P(P(C(1), 0, C(1), 3), 2, P(C(5), 1), 4);
+  q = P(P(C(1), 1), 0, C(-1), 1);
+  Poly args[2] = {P(C(1), 1), PolyClone(&q)};
+  res &= TestEq(PolySubstVar(&p, 1, &q), PolyCompose(&p, 2, args), true);
+  PolyDestroy(&args[0]);
+  PolyDestroy(&args[1]);
+  args[0] = q;
+  args[1] = P(P(C(1), 1), 0);
+  res &= TestEq(PolySubstVar(&p, 0, &q), PolyCompose(&p, 2, args), true);
+  for (size_t i = 0; i < 2; ++i)
+    PolyDestroy(&args[i]);
+  PolyDestroy(&p);
+  return res;
+}
+
+/**
+ * Sprawdza wyliczanie wartości wielomianu w punkcie dla jednej zmiennej
+ * przez PolyAtVar.
+ */
+static bool AtVarTest(void) {
+  bool res = true;
+  Poly p = P(C(3), 0, P(C(1), 2), 1, P(P(C(1), 1), 1), 2);
+  res &= TestEq(PolyAtVar(&p, 1, 2),
+                P(C(3), 0, C(4), 1, P(C(2), 1), 2), true);
+  res &= TestEq(PolyAtVar(&p, 2, -1),
+                P(C(3), 0, P(C(1), 2), 1, P(C(-1), 1), 2), true);
+  res &= TestEq(PolyAtVar(&p, 0, 5), PolyAt(&p, 5), true);
+  res &= TestEq(PolyAtVar(&p, 3, 7), PolyClone(&p), true);
+  PolyDestroy(&p);
+
+  p = P(P(C(-2), 0, C(1), 1), 1);
+  res &= TestEq(PolyAtVar(&p, 1, 2), C(0), true);
+  PolyDestroy(&p);
+
+  p = P(P(C(1), 0, C(1), 1), 0, C(1), 1);
+  res &= TestEq(PolyAtVar(&p, 1, 4), P(C(5), 0, C(1), 1), true);
+  PolyDestroy(&p);
+  return res;
+}
+
 /**
  * Sprawdza zużycie pamięci dla rzadkich wielomianów.
  */
@@ -4001,16 +4798,38 @@ static bool MemoryGroup(void) {
 #define TEST_PASS  0
 #define TEST_FAIL  125
 #define TEST_WRONG 2
+#define TEST_SKIP  77
 
 // Liczba elementów tablicy x
 #define SIZE(x) (sizeof (x) / sizeof (x)[0])
 
+// Założenia testu o typach, których wariant biblioteki może nie spełniać:
+// 64-bitowe współczynniki (stałe takie jak 1L << 32, przepełnienia, duże
+// moduły) i co najmniej 32-bitowe wykładniki.
+#define NEEDS_COEFF64 1u
+#define NEEDS_EXP32   2u
+
 typedef struct {
   char const *name;
   bool (*function)(void);
+  unsigned needs;
 } test_list_t;
 
-#define TEST(t) {#t, t}
+#define TEST(t) {#t, t, 0}
+#define TEST_NEEDS(t, needs) {#t, t, needs}
+
+/**
+ * Sprawdza, czy wariant biblioteki spełnia założenia testu.
+ * @param[in] needs : założenia NEEDS_*
+ * @return Czy test ma sens dla tego wariantu?
+ */
+static bool TestSupported(unsigned needs) {
+  if ((needs & NEEDS_COEFF64) && sizeof (poly_coeff_t) != sizeof (int64_t))
+    return false;
+  if ((needs & NEEDS_EXP32) && sizeof (poly_exp_t) < sizeof (int32_t))
+    return false;
+  return true;
+}
 
 static const test_list_t test_list[] = {
   TEST(SimpleAddTest),
@@ -4024,12 +4843,22 @@ static const test_list_t test_list[] = {
   TEST(SimpleDegGroup),
   TEST(SimpleIsEqTest),
   TEST(SimpleAtTest),
-  TEST(OverflowTest),
+  TEST_NEEDS(OverflowTest, NEEDS_COEFF64),
+  TEST_NEEDS(CoeffOverflowTest, NEEDS_COEFF64),
+  TEST_NEEDS(ExactTest, NEEDS_COEFF64),
+  TEST_NEEDS(ModulusTest, NEEDS_COEFF64),
+  TEST_NEEDS(CrtTest, NEEDS_COEFF64),
+  TEST_NEEDS(InPlaceTest, NEEDS_COEFF64),
+  TEST_NEEDS(ScaledPowerTest, NEEDS_COEFF64),
+  TEST(ManyMonosTest),
+  TEST(BuilderTest),
+  TEST(AccumulatorTest),
+  TEST(FmaTest),
   TEST(SimpleArithmeticTest),
-  TEST(LongPolynomialTest),
-  TEST(AtTest1),
+  TEST_NEEDS(LongPolynomialTest, NEEDS_COEFF64 | NEEDS_EXP32),
+  TEST_NEEDS(AtTest1, NEEDS_COEFF64),
   TEST(AtTest2),
-  TEST(AtGroup),
+  TEST_NEEDS(AtGroup, NEEDS_COEFF64),
   TEST(DegreeOpChangeTest),
   TEST(DegTest),
   TEST(DegByTest),
@@ -4042,19 +4871,34 @@ static const test_list_t test_list[] = {
   TEST(SubTest2),
   TEST(ArithmeticGroup),
   TEST(IsEqTest),
-  TEST(RarePolynomialTest),
+  TEST(IsEqProbableTest),
+  TEST(HashTest),
+  TEST(DegVectorTest),
+  TEST_NEEDS(NormalizationTest, NEEDS_COEFF64),
+  TEST(SqrTest),
+  TEST_NEEDS(PowTest, NEEDS_COEFF64),
+  TEST(TruncTest),
+  TEST(MonomialTest),
+  TEST(ShiftTest),
+  TEST(SubstVarTest),
+  TEST(AtVarTest),
+  TEST_NEEDS(RarePolynomialTest, NEEDS_EXP32),
   TEST(MemoryThiefTest),
   TEST(MemoryFreeTest),
-  TEST(MemoryGroup),
+  TEST_NEEDS(MemoryGroup, NEEDS_EXP32),
 };
 
 int main(int argc, char *argv[]) {
   if (argc != 2)
     return TEST_WRONG;
 
-  for (size_t i = 0; i < SIZE(test_list); ++i)
-    if (strcmp(argv[1], test_list[i].name) == 0)
+  for (size_t i = 0; i < SIZE(test_list); ++i) {
+    if (strcmp(argv[1], test_list[i].name) == 0) {
+      if (!TestSupported(test_list[i].needs))
+        return TEST_SKIP;
       return test_list[i].function() ? TEST_PASS : TEST_FAIL;
+    }
+  }
 
   return TEST_WRONG;
 }
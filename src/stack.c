@@ -47,9 +47,7 @@ void StackPush(const Poly *p, Stack *s) {
 
 Poly StackPop(Stack *s) {
     s->pick--;
-    Poly p = PolyClone(&s->array[s->pick]);
-    PolyDestroy(&s->array[s->pick]);
-    return p;
+    return s->array[s->pick];
 }
 
 Poly StackTop(Stack *s) {
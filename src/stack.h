@@ -64,6 +64,7 @@ void StackPush(const Poly *p, Stack *s);
 
 /**
  * Zwraca wielomian z wierzchołka stosu jednocześnie go zdejmując.
+ * Wielomian nie jest kopiowany – wywołujący przejmuje go na własność.
  * @param[in] s : stos
  * @return wielomian z wierzchołka stosu
  */